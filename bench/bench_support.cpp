@@ -0,0 +1,174 @@
+#include "bench_support.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <new>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    std::atomic<uint64_t> allocation_count = 0;
+}
+
+void* operator new(size_t size)
+{
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+
+    if (void* memory = std::malloc(size ? size : 1))
+        return memory;
+
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory, size_t) noexcept
+{
+    std::free(memory);
+}
+
+uint64_t get_allocation_count() noexcept
+{
+    return allocation_count.load(std::memory_order_relaxed);
+}
+
+size_t get_peak_resident_set_size() noexcept
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return counters.PeakWorkingSetSize;
+
+    return 0;
+#else
+    rusage usage;
+
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+
+#ifdef __APPLE__
+    return static_cast<size_t>(usage.ru_maxrss);
+#else
+    return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+double get_percentile(std::vector<double> values, double percentile) noexcept
+{
+    if (values.empty())
+        return 0.0;
+
+    // Nearest rank, so the result is always one of the measured values
+    std::ranges::sort(values);
+    size_t rank = static_cast<size_t>(std::ceil(percentile / 100.0 * static_cast<double>(values.size())));
+
+    return values[std::clamp<size_t>(rank, 1, values.size()) - 1];
+}
+
+#ifdef __linux__
+
+CacheMissCounter::CacheMissCounter() noexcept
+{
+    perf_event_attr attributes = {};
+    attributes.type = PERF_TYPE_HARDWARE;
+    attributes.size = sizeof(attributes);
+    attributes.config = PERF_COUNT_HW_CACHE_MISSES;
+    attributes.disabled = 1;
+    attributes.exclude_kernel = 1;
+    attributes.exclude_hv = 1;
+
+    _file = static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0));
+}
+
+CacheMissCounter::~CacheMissCounter() noexcept
+{
+    if (_file >= 0)
+        close(_file);
+}
+
+bool CacheMissCounter::is_available() const noexcept
+{
+    return _file >= 0;
+}
+
+void CacheMissCounter::start() noexcept
+{
+    if (_file < 0)
+        return;
+
+    ioctl(_file, PERF_EVENT_IOC_RESET, 0);
+    ioctl(_file, PERF_EVENT_IOC_ENABLE, 0);
+}
+
+uint64_t CacheMissCounter::stop() noexcept
+{
+    if (_file < 0)
+        return 0;
+
+    ioctl(_file, PERF_EVENT_IOC_DISABLE, 0);
+
+    uint64_t count = 0;
+
+    if (read(_file, &count, sizeof(count)) != sizeof(count))
+        return 0;
+
+    return count;
+}
+
+#else
+
+CacheMissCounter::CacheMissCounter() noexcept = default;
+CacheMissCounter::~CacheMissCounter() noexcept = default;
+
+bool CacheMissCounter::is_available() const noexcept
+{
+    return false;
+}
+
+void CacheMissCounter::start() noexcept
+{
+}
+
+uint64_t CacheMissCounter::stop() noexcept
+{
+    return 0;
+}
+
+#endif
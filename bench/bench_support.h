@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Number of global operator new calls since program start, counted by the replacement in bench_support.cpp
+[[nodiscard]] uint64_t get_allocation_count() noexcept;
+
+// Peak resident set size of the process in bytes, 0 where the platform offers no counter
+[[nodiscard]] size_t get_peak_resident_set_size() noexcept;
+
+[[nodiscard]] double get_percentile(std::vector<double> values, double percentile) noexcept;
+
+// Hardware cache miss counter of the calling thread, only available on Linux with perf events enabled
+class CacheMissCounter final
+{
+public:
+    CacheMissCounter() noexcept;
+    ~CacheMissCounter() noexcept;
+
+    CacheMissCounter(const CacheMissCounter&) = delete;
+    CacheMissCounter& operator=(const CacheMissCounter&) = delete;
+
+    [[nodiscard]] bool is_available() const noexcept;
+    void start() noexcept;
+    [[nodiscard]] uint64_t stop() noexcept;
+
+private:
+    int _file = -1;
+};
@@ -0,0 +1,354 @@
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <fmt/core.h>
+#include <fmt/os.h>
+
+#include "bench_support.h"
+#include "json.h"
+#include "profiler.h"
+#include "puzzle_solver.h"
+
+// Solves every puzzle of res/puzzles plus generated scaling instances several times and reports
+// wall time percentiles, search throughput, memory and allocation counts as a table and as JSON
+namespace
+{
+    struct Instance
+    {
+        std::string name;
+        std::vector<std::vector<utils::int3>> pieces;
+        std::vector<utils::int3> positions;
+    };
+
+    struct Result
+    {
+        std::string name;
+        size_t num_pieces = 0;
+        size_t grid_size = 0;
+        OccupancyBackend backend = OccupancyBackend::Auto;
+        SearchMode mode = SearchMode::Greedy;
+        ExpansionMode expansion = ExpansionMode::Full;
+        SolveStatus status = SolveStatus::NotStarted;
+        int moves = 0;
+        int nodes = 0;
+        uint64_t expansions = 0;
+        double median_ms = 0.0;
+        double p95_ms = 0.0;
+        double nodes_per_second = 0.0;
+        double allocations_per_node = 0.0;
+        size_t peak_memory = 0;
+        double bytes_per_state = 0.0;
+        size_t peak_resident_set_size = 0;
+        std::string profile;
+        std::string search_statistics;
+    };
+
+    struct Options
+    {
+        std::filesystem::path puzzles = "res/puzzles";
+        std::filesystem::path json;
+        std::filesystem::path trace;
+        std::string filter;
+        uint32_t trace_sampling = 1;
+        int repeat = 5;
+        SolverLimits limits = {60000.0, 0};
+        SearchOptions search;
+        OccupancyBackend backend = OccupancyBackend::Auto;
+    };
+
+    // Every unit cube becomes a scale^3 block, so pieces have to travel scale times as far to separate
+    Instance scale_instance(const Instance& instance, int scale)
+    {
+        Instance scaled = {fmt::format("{}_x{}", instance.name, scale), {}, {}};
+
+        utils::int3 origin = instance.positions[0];
+
+        for (const auto& position : instance.positions) {
+            for (size_t axis = 0; axis < 3; axis++) {
+                origin[axis] = std::min(origin[axis], position[axis]);
+            }
+        }
+
+        for (size_t i = 0; i < instance.pieces.size(); i++) {
+            std::vector<utils::int3> cubes;
+
+            for (const auto& cube : instance.pieces[i]) {
+                for (int z = 0; z < scale; z++) {
+                    for (int y = 0; y < scale; y++) {
+                        for (int x = 0; x < scale; x++) {
+                            cubes.push_back({cube.x * scale + x, cube.y * scale + y, cube.z * scale + z});
+                        }
+                    }
+                }
+            }
+
+            const utils::int3& position = instance.positions[i];
+            scaled.pieces.push_back(std::move(cubes));
+            scaled.positions.push_back({origin.x + (position.x - origin.x) * scale, origin.y + (position.y - origin.y) * scale, origin.z + (position.z - origin.z) * scale});
+        }
+
+        return scaled;
+    }
+
+    std::vector<Instance> collect_instances(const Options& options)
+    {
+        std::vector<std::filesystem::path> paths;
+
+        for (const auto& entry : std::filesystem::directory_iterator(options.puzzles)) {
+            if (entry.is_regular_file() && (entry.path().extension() == ".txt" || entry.path().extension() == ".bpz"))
+                paths.push_back(entry.path());
+        }
+
+        std::ranges::sort(paths);
+
+        std::vector<Instance> instances;
+
+        for (const auto& path : paths) {
+            Instance instance = {path.stem().string(), {}, {}};
+            std::vector<PuzzleParseError> errors;
+
+            if (!read_puzzle(path, instance.pieces, instance.positions, errors)) {
+                fmt::println("Skipping {}: {}", path.string(), errors.front().message);
+                continue;
+            }
+
+            instances.push_back(std::move(instance));
+
+            if (path.stem() == "Puzzle6") {
+                const Instance base = instances.back();
+
+                // The x6 instance needs a grid beyond the dense backend and runs on sparse bricks
+                for (int scale : {2, 3, 6}) {
+                    instances.push_back(scale_instance(base, scale));
+                }
+            }
+        }
+
+        std::erase_if(instances, [&](const Instance& instance) { return instance.name.find(options.filter) == std::string::npos; });
+
+        return instances;
+    }
+
+    Result run_instance(const Instance& instance, const Options& options)
+    {
+        Result result;
+        result.name = instance.name;
+        result.num_pieces = instance.pieces.size();
+
+        std::vector<double> times;
+        uint64_t allocations = 0;
+        uint64_t nodes = 0;
+
+        for (int run = 0; run < options.repeat; run++) {
+            std::unique_ptr<PuzzleSolver> wizard = create_puzzle_solver(get_required_grid_size(instance.pieces, instance.positions), options.backend);
+
+            if (!wizard) {
+                fmt::println("Skipping {}: needs a grid larger than the {} backend supports", instance.name, to_string(options.backend));
+                return result;
+            }
+
+            if (!wizard->load_puzzle(instance.pieces, instance.positions)) {
+                fmt::println("Skipping {}: {}", instance.name, wizard->get_load_errors().front().message);
+                return result;
+            }
+
+            wizard->init_field();
+            wizard->init_start_node();
+            wizard->set_limits(options.limits);
+            wizard->set_search_options(options.search);
+
+#ifdef BURR_PUZZLE_WIZARD_PROFILE
+            Profiler::get().set_trace_sampling(options.trace.empty() ? 0 : options.trace_sampling);
+#endif
+
+            const uint64_t allocations_before = get_allocation_count();
+            auto start = std::chrono::steady_clock::now();
+
+            wizard->solve();
+
+            auto end = std::chrono::steady_clock::now();
+            allocations += get_allocation_count() - allocations_before;
+            nodes += static_cast<uint64_t>(wizard->get_nodes_visited());
+
+            times.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+
+            result.grid_size = wizard->get_dim();
+            result.backend = wizard->get_backend();
+            result.mode = options.search.mode;
+            result.expansion = options.search.expansion;
+            result.status = wizard->get_status();
+            result.moves = wizard->get_solution().get_num_moves();
+            result.nodes = wizard->get_nodes_visited();
+            result.expansions = wizard->get_search_statistics().get_expansions();
+            result.peak_memory = std::max(result.peak_memory, wizard->get_peak_memory_usage());
+            result.bytes_per_state = wizard->get_memory_usage().get_bytes_per_state();
+            result.search_statistics = wizard->get_search_statistics().to_json();
+        }
+
+        double total_ms = 0.0;
+
+        for (double time : times) {
+            total_ms += time;
+        }
+
+        result.median_ms = get_percentile(times, 50.0);
+        result.p95_ms = get_percentile(times, 95.0);
+        result.nodes_per_second = total_ms > 0.0 ? static_cast<double>(nodes) / (total_ms / 1000.0) : 0.0;
+        result.allocations_per_node = nodes > 0 ? static_cast<double>(allocations) / static_cast<double>(nodes) : 0.0;
+        result.peak_resident_set_size = get_peak_resident_set_size();
+
+#ifdef BURR_PUZZLE_WIZARD_PROFILE
+        // Phase totals of the last repeat, the profiler is reset at the start of every solve
+        result.profile = Profiler::get().get_summary();
+#endif
+
+        return result;
+    }
+
+    void print_table(const std::vector<Result>& results)
+    {
+        fmt::println("{:<24} {:>6} {:>4} {:>12} {:>6} {:>8} {:>8} {:>11} {:>11} {:>12} {:>12} {:>9} {:>10} {:>12}",
+                     "puzzle", "pieces", "grid", "status", "moves", "nodes", "expanded", "median ms", "p95 ms", "nodes/s", "peak memory", "B/state", "rss MiB", "allocs/node");
+
+        for (const auto& result : results) {
+            fmt::println("{:<24} {:>6} {:>4} {:>12} {:>6} {:>8} {:>8} {:>11.2f} {:>11.2f} {:>12.0f} {:>12} {:>9.0f} {:>10.1f} {:>12.0f}",
+                         result.name, result.num_pieces, result.grid_size, to_string(result.status), result.moves, result.nodes, result.expansions, result.median_ms, result.p95_ms,
+                         result.nodes_per_second, result.peak_memory, result.bytes_per_state, static_cast<double>(result.peak_resident_set_size) / (1 << 20), result.allocations_per_node);
+        }
+
+        for (const auto& result : results) {
+            if (!result.profile.empty())
+                fmt::print("\n{}\n{}", result.name, result.profile);
+        }
+    }
+
+    void write_json(const std::filesystem::path& path, const std::vector<Result>& results, const Options& options)
+    {
+        auto file = fmt::output_file(path.string());
+
+#ifdef NDEBUG
+        constexpr bool optimized = true;
+#else
+        constexpr bool optimized = false;
+#endif
+
+        file.print("{{\n  \"repeat\": {},\n  \"optimized\": {},\n  \"results\": [\n", options.repeat, optimized);
+
+        for (size_t i = 0; i < results.size(); i++) {
+            const Result& result = results[i];
+
+            file.print(R"(    {{"puzzle": "{}", "pieces": {}, "grid_size": {}, "backend": "{}", "mode": "{}", "expansion": "{}", "status": "{}", "moves": {}, "nodes": {}, "expansions": {}, "median_ms": {:.4f}, "p95_ms": {:.4f}, )"
+                       R"("nodes_per_second": {:.1f}, "peak_memory": {}, "bytes_per_state": {:.1f}, "peak_rss": {}, "allocations_per_node": {:.2f}, "search_statistics": {}}}{})",
+                       escape_json(result.name), result.num_pieces, result.grid_size, to_string(result.backend), to_string(result.mode), to_string(result.expansion), to_string(result.status), result.moves, result.nodes, result.expansions, result.median_ms, result.p95_ms,
+                       result.nodes_per_second, result.peak_memory, result.bytes_per_state, result.peak_resident_set_size, result.allocations_per_node, result.search_statistics, i + 1 < results.size() ? ",\n" : "\n");
+        }
+
+        file.print("  ]\n}}\n");
+    }
+
+    template <typename T>
+    bool parse_number(std::string_view text, T& value)
+    {
+        auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+        return error == std::errc() && end == text.data() + text.size();
+    }
+
+    bool parse_options(int argc, char** argv, Options& options)
+    {
+        for (int i = 1; i < argc; i++) {
+            std::string_view argument = argv[i];
+
+            if (i + 1 == argc)
+                return false;
+
+            if (argument == "--puzzles")
+                options.puzzles = argv[++i];
+            else if (argument == "--json")
+                options.json = argv[++i];
+            else if (argument == "--filter")
+                options.filter = argv[++i];
+            else if (argument == "--trace")
+                options.trace = argv[++i];
+            else if (argument == "--trace-sampling") {
+                if (!parse_number(argv[++i], options.trace_sampling) || options.trace_sampling == 0)
+                    return false;
+            }
+            else if (argument == "--repeat") {
+                if (!parse_number(argv[++i], options.repeat) || options.repeat < 1)
+                    return false;
+            } else if (argument == "--time-limit") {
+                if (!parse_number(argv[++i], options.limits.max_time_ms))
+                    return false;
+            } else if (argument == "--backend") {
+                if (!parse_occupancy_backend(argv[++i], options.backend))
+                    return false;
+            } else if (argument == "--mode") {
+                if (!parse_search_mode(argv[++i], options.search.mode))
+                    return false;
+            } else if (argument == "--expansion") {
+                if (!parse_expansion_mode(argv[++i], options.search.expansion))
+                    return false;
+            } else {
+                return false;
+            }
+        }
+
+        return true;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+
+    if (!parse_options(argc, argv, options)) {
+        fmt::println("Usage: {} [--puzzles DIR] [--repeat N] [--filter TEXT] [--time-limit MS] [--backend auto|dense|sparse] [--mode greedy|astar|bfs] [--expansion full|partial] [--json FILE] [--trace FILE] [--trace-sampling N]", argv[0]);
+        return 1;
+    }
+
+#ifndef BURR_PUZZLE_WIZARD_PROFILE
+    if (!options.trace.empty())
+        fmt::println("Warning: --trace needs a build with BURR_PUZZLE_WIZARD_PROFILE enabled\n");
+#endif
+
+#ifndef NDEBUG
+    fmt::println("Warning: benchmark built without optimizations, use a Release build for comparable numbers\n");
+#endif
+
+    std::vector<Result> results;
+
+    // Instances run smallest first, so the process peak RSS reported per row is dominated by that row
+    std::vector<Instance> instances = collect_instances(options);
+    std::ranges::stable_sort(instances, {}, [](const Instance& instance) {
+        size_t cubes = 0;
+
+        for (const auto& piece : instance.pieces) {
+            cubes += piece.size();
+        }
+
+        return cubes;
+    });
+
+    for (const auto& instance : instances) {
+        results.push_back(run_instance(instance, options));
+    }
+
+    print_table(results);
+
+    if (!options.json.empty())
+        write_json(options.json, results, options);
+
+#ifdef BURR_PUZZLE_WIZARD_PROFILE
+    // The trace covers the last solve, use --filter to pick the puzzle
+    if (!options.trace.empty() && !Profiler::get().write_chrome_trace(options.trace))
+        fmt::println("Failed to write trace to {}", options.trace.string());
+#endif
+
+    return 0;
+}
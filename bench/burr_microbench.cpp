@@ -0,0 +1,258 @@
+#include <bit>
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include <fmt/core.h>
+
+#include "bench_support.h"
+#include "burr_puzzle_wizard.h"
+#include "row_kernels.h"
+#include "solver_kernels.h"
+
+namespace
+{
+    const utils::int3 directions[6] = {{-1, 0, 0}, {1, 0, 0}, {0, -1, 0}, {0, 1, 0}, {0, 0, -1}, {0, 0, 1}};
+
+    constexpr double min_duration_ns = 1e8;
+
+    volatile size_t sink = 0;
+
+    struct Measurement
+    {
+        uint64_t ops = 0;
+        double ns = 0.0;
+        uint64_t allocations = 0;
+        uint64_t cache_misses = 0;
+    };
+
+    // Calls `setup` untimed and `kernel` timed for every state until enough time has been sampled
+    Measurement measure(size_t num_states, CacheMissCounter& counter, const std::function<void(size_t)>& setup, const std::function<uint64_t(size_t)>& kernel)
+    {
+        Measurement measurement;
+
+        while (measurement.ns < min_duration_ns && num_states > 0) {
+            for (size_t state = 0; state < num_states; state++) {
+                setup(state);
+
+                const uint64_t allocations = get_allocation_count();
+                counter.start();
+                auto start = std::chrono::steady_clock::now();
+
+                measurement.ops += kernel(state);
+
+                auto end = std::chrono::steady_clock::now();
+                measurement.cache_misses += counter.stop();
+                measurement.allocations += get_allocation_count() - allocations;
+                measurement.ns += std::chrono::duration<double, std::nano>(end - start).count();
+            }
+        }
+
+        return measurement;
+    }
+
+    void print_measurement(const std::string& kernel, const std::string& puzzle, size_t grid_size, std::string_view backend, const Measurement& measurement, bool cache_misses)
+    {
+        const double ops = static_cast<double>(std::max<uint64_t>(measurement.ops, 1));
+
+        fmt::println("{:<20} {:<12} {:>4} {:<7} {:>10} {:>12.1f} {:>12.2f} {:>14}", kernel, puzzle, grid_size, backend, measurement.ops, measurement.ns / ops,
+                     static_cast<double>(measurement.allocations) / ops, cache_misses ? fmt::format("{:.2f}", static_cast<double>(measurement.cache_misses) / ops) : "n/a");
+    }
+
+    template <size_t N, typename Occupancy = DenseOccupancy<N>>
+    void run_kernels(const std::filesystem::path& path, CacheMissCounter& counter)
+    {
+        const std::string puzzle = path.stem().string();
+        auto wizard = std::make_unique<BurrPuzzleWizard<N, Occupancy>>();
+        const std::string_view backend = to_string(wizard->get_backend());
+
+        if (!wizard->read_puzzle_from_file(path)) {
+            fmt::println("{:<20} {:<12} {:>4} {:<7} skipped: {}", "-", puzzle, N, backend, wizard->get_load_errors().front().message);
+            return;
+        }
+
+        wizard->init_field();
+        wizard->init_start_node();
+
+        if (!wizard->solve()) {
+            fmt::println("{:<20} {:<12} {:>4} {:<7} skipped: not solvable at this grid size", "-", puzzle, N, backend);
+            return;
+        }
+
+        BurrPuzzleWizardKernels<N, Occupancy> kernels(*wizard);
+
+        // The states along the solution and every neighbor generated from them, with the state each neighbor came from
+        const RecordedStates recorded = record_states(*wizard, kernels);
+        const std::vector<Node>& states = recorded.states;
+        const std::vector<size_t>& parents = recorded.parents;
+        const std::vector<size_t>& children = recorded.children;
+        const std::vector<BlockingGraphs>& parent_graphs = recorded.parent_graphs;
+
+        std::vector<std::vector<int>> pieces(states.size());
+        std::vector<uint64_t> piece_masks(states.size());
+        BlockingGraphs graphs;
+
+        for (size_t state = 0; state < states.size(); state++) {
+            const auto& free_pieces = states[state].get_free_pieces();
+
+            for (size_t piece = 0; piece < kernels.get_num_pieces(); piece++) {
+                if (!free_pieces[piece]) {
+                    pieces[state].push_back(static_cast<int>(piece));
+                    piece_masks[state] |= uint64_t(1) << piece;
+                }
+            }
+        }
+
+        auto no_setup = [](size_t) {};
+        auto build_field = [&](size_t state) { kernels.build_field(states[state]); };
+        auto build_contacts = [&](size_t state) { kernels.build_contacts(states[state]); };
+        auto build_graphs = [&](size_t state) { graphs = kernels.build_blocking_graphs(states[state]); };
+
+        const bool cache_misses = counter.is_available();
+
+        print_measurement("build_field", puzzle, N, backend, measure(states.size(), counter, no_setup, [&](size_t state) {
+            kernels.build_field(states[state]);
+            return uint64_t(1);
+        }), cache_misses);
+
+        auto collides = [&](size_t state) {
+            uint64_t ops = 0;
+
+            for (int piece : pieces[state]) {
+                for (const auto& direction : directions) {
+                    sink = sink + kernels.collides(uint64_t(1) << piece, states[state].get_positions(), direction);
+                    ops++;
+                }
+            }
+
+            return ops;
+        };
+
+        print_measurement("collides", puzzle, N, backend, measure(states.size(), counter, build_field, collides), cache_misses);
+
+        // The dense field tests rows with the best instruction set of the CPU, compare it with the lower ones
+        if constexpr (std::is_same_v<Occupancy, DenseOccupancy<N>>) {
+            for (auto isa : {row_kernels::Isa::Scalar, row_kernels::Isa::Avx2, row_kernels::Isa::Avx512}) {
+                if (isa > row_kernels::get_supported_isa())
+                    continue;
+
+                row_kernels::set_isa(isa);
+                print_measurement(fmt::format("collides/{}", row_kernels::to_string(isa)), puzzle, N, backend, measure(states.size(), counter, build_field, collides), cache_misses);
+            }
+
+            row_kernels::set_isa(row_kernels::get_supported_isa());
+        }
+
+        print_measurement("contact_index", puzzle, N, backend, measure(states.size(), counter, no_setup, [&](size_t state) {
+            kernels.build_contacts(states[state]);
+            sink = sink + kernels.get_num_contact_pairs();
+
+            return uint64_t(1);
+        }), cache_misses);
+
+        print_measurement("get_collisions", puzzle, N, backend, measure(states.size(), counter, build_contacts, [&](size_t state) {
+            uint64_t ops = 0;
+
+            for (int piece : pieces[state]) {
+                for (const auto& direction : directions) {
+                    sink = sink + static_cast<size_t>(std::popcount(kernels.get_collisions(piece, direction, states[state])));
+                    ops++;
+                }
+            }
+
+            return ops;
+        }), cache_misses);
+
+        print_measurement("strongly_connected", puzzle, N, backend, measure(states.size(), counter, build_graphs, [&](size_t state) {
+            for (size_t direction = 0; direction < BlockingGraphs::directions.size(); direction++) {
+                sink = sink + kernels.find_strongly_connected_components(graphs, direction, piece_masks[state]);
+            }
+
+            return uint64_t(BlockingGraphs::directions.size());
+        }), cache_misses);
+
+        print_measurement("node_construction", puzzle, N, backend, measure(states.size(), counter, no_setup, [&](size_t state) {
+            Node node = kernels.make_node(states[state].get_positions());
+            sink = sink + node.get_key().size();
+
+            return uint64_t(1);
+        }), cache_misses);
+
+        print_measurement("node_hash", puzzle, N, backend, measure(states.size(), counter, no_setup, [&](size_t state) {
+            sink = sink + std::hash<Node>()(states[state]);
+
+            return uint64_t(1);
+        }), cache_misses);
+
+        // Should not allocate once the first state has grown the scratch buffers
+        print_measurement("expand", puzzle, N, backend, measure(states.size(), counter, build_field, [&](size_t state) {
+            sink = sink + kernels.expand(states[state]);
+
+            return uint64_t(1);
+        }), cache_misses);
+
+        print_measurement("neighbor_nodes", puzzle, N, backend, measure(states.size(), counter, build_field, [&](size_t state) {
+            sink = sink + kernels.get_neighbor_nodes(states[state]).size();
+
+            return uint64_t(1);
+        }), cache_misses);
+
+        // Blocking graphs of the recorded neighbors, built from scratch and derived from the parent
+        auto build_child_contacts = [&](size_t child) { kernels.build_contacts(states[children[child]]); };
+
+        print_measurement("blocking_graph/full", puzzle, N, backend, measure(children.size(), counter, build_child_contacts, [&](size_t child) {
+            sink = sink + kernels.rebuild_blocking_graphs(states[children[child]]).get_blockers(0, 0);
+
+            return uint64_t(1);
+        }), cache_misses);
+
+        print_measurement("blocking_graph/incr", puzzle, N, backend, measure(children.size(), counter, build_child_contacts, [&](size_t child) {
+            const size_t parent = parents[children[child]];
+            sink = sink + kernels.update_blocking_graphs(states[children[child]], states[parent], parent_graphs[parent]).get_blockers(0, 0);
+
+            return uint64_t(1);
+        }), cache_misses);
+
+        // Same expansions of the recorded neighbors, once with graphs built from scratch and once derived from the parent
+        auto build_child_field = [&](size_t child) { kernels.build_field(states[children[child]]); };
+
+        print_measurement("neighbor_nodes/full", puzzle, N, backend, measure(children.size(), counter, build_child_field, [&](size_t child) {
+            sink = sink + kernels.get_neighbor_nodes(states[children[child]]).size();
+
+            return uint64_t(1);
+        }), cache_misses);
+
+        print_measurement("neighbor_nodes/incr", puzzle, N, backend, measure(children.size(), counter, build_child_field, [&](size_t child) {
+            const size_t parent = parents[children[child]];
+            sink = sink + kernels.get_neighbor_nodes(states[children[child]], &states[parent], &parent_graphs[parent]).size();
+
+            return uint64_t(1);
+        }), cache_misses);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const std::filesystem::path puzzles = argc > 1 ? argv[1] : "res/puzzles";
+
+    CacheMissCounter counter;
+
+    fmt::println("{:<20} {:<12} {:>4} {:<7} {:>10} {:>12} {:>12} {:>14}", "kernel", "puzzle", "N", "backend", "ops", "ns/op", "allocs/op", "cache-miss/op");
+
+    for (const char* name : {"Puzzle6.txt", "Puzzle18.txt"}) {
+        const std::filesystem::path path = puzzles / name;
+
+        run_kernels<24>(path, counter);
+        run_kernels<32>(path, counter);
+        run_kernels<48>(path, counter);
+        run_kernels<64>(path, counter);
+        run_kernels<64, SparseOccupancy>(path, counter);
+        run_kernels<256, SparseOccupancy>(path, counter);
+    }
+
+    return 0;
+}
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "burr_puzzle_wizard.h"
+
+// Drives the inner-loop kernels of the solver through its private search primitives, shared by the microbench and
+// the tests
+template <size_t N, typename Occupancy>
+class BurrPuzzleWizardKernels final
+{
+public:
+    explicit BurrPuzzleWizardKernels(BurrPuzzleWizard<N, Occupancy>& wizard) noexcept : _wizard(wizard)
+    {
+    }
+
+    void build_field(const Node& node) noexcept
+    {
+        _wizard._build_field_from_node(node);
+    }
+
+    [[nodiscard]] bool collides(uint64_t pieces, const std::vector<utils::int3>& positions, utils::int3 direction) const noexcept
+    {
+        return _wizard._collides(pieces, positions, direction);
+    }
+
+    void build_contacts(const Node& node) noexcept
+    {
+        _contacts.build(node.get_positions(), _wizard._extents, node.get_free_pieces());
+    }
+
+    [[nodiscard]] size_t get_num_contact_pairs() const noexcept
+    {
+        return _contacts.get_num_pairs();
+    }
+
+    // Uses the contact index of the last build_contacts
+    [[nodiscard]] uint64_t get_collisions(size_t piece, utils::int3 direction, const Node& node) const noexcept
+    {
+        return _wizard._get_collisions(piece, direction, node, _contacts);
+    }
+
+    [[nodiscard]] BlockingGraphs build_blocking_graphs(const Node& node) noexcept
+    {
+        BlockingGraphs graphs;
+
+        build_contacts(node);
+        _wizard._build_blocking_graphs(node, _contacts, graphs);
+
+        return graphs;
+    }
+
+    // Uses the contact index of the last build_contacts
+    [[nodiscard]] const BlockingGraphs& rebuild_blocking_graphs(const Node& node) noexcept
+    {
+        _wizard._build_blocking_graphs(node, _contacts, _graphs);
+        return _graphs;
+    }
+
+    // Uses the contact index of the last build_contacts
+    [[nodiscard]] const BlockingGraphs& update_blocking_graphs(const Node& node, const Node& parent, const BlockingGraphs& parent_graphs) noexcept
+    {
+        _wizard._update_blocking_graphs(node, parent, parent_graphs, _contacts, _graphs);
+        return _graphs;
+    }
+
+    [[nodiscard]] size_t find_strongly_connected_components(const BlockingGraphs& graphs, size_t direction, uint64_t pieces) noexcept
+    {
+        _wizard._find_strongly_connected_components(graphs, direction, pieces, _components);
+        return _components.size();
+    }
+
+    // A node with the solver's symmetries, keyed like the nodes of its search
+    [[nodiscard]] Node make_node(const std::vector<utils::int3>& positions) const noexcept
+    {
+        return Node(positions, static_cast<int>(N), &_wizard._symmetries);
+    }
+
+    // Builds a node for every neighbor, deriving the blocking graphs from the parent's when they are given
+    [[nodiscard]] std::vector<Node> get_neighbor_nodes(const Node& node, const Node* parent = nullptr, const BlockingGraphs* parent_graphs = nullptr) noexcept
+    {
+        std::vector<Node> neighbors;
+
+        _wizard._expand(node, _graphs, parent, parent_graphs, [&](const std::vector<utils::int3>& positions) { neighbors.push_back(make_node(positions)); });
+
+        return neighbors;
+    }
+
+    // Generates the neighbors without building nodes for them, the part of an expansion that reuses scratch buffers
+    [[nodiscard]] size_t expand(const Node& node, const Node* parent = nullptr, const BlockingGraphs* parent_graphs = nullptr) noexcept
+    {
+        size_t num_neighbors = 0;
+
+        _wizard._expand(node, _graphs, parent, parent_graphs, [&](const std::vector<utils::int3>&) { num_neighbors++; });
+
+        return num_neighbors;
+    }
+
+    [[nodiscard]] size_t get_num_pieces() const noexcept
+    {
+        return _wizard.get_num_pieces();
+    }
+
+private:
+    BurrPuzzleWizard<N, Occupancy>& _wizard;
+    ContactIndex _contacts;
+    BlockingGraphs _graphs;
+    std::vector<uint64_t> _components;
+};
+
+// States of a solved puzzle: every state on the solver's path except the last, and every neighbor generated from them
+struct RecordedStates
+{
+    std::vector<Node> states;
+    // Index of the state each state was generated from, a path state is its own parent
+    std::vector<size_t> parents;
+    // Indices of the neighbors
+    std::vector<size_t> children;
+    // Blocking graphs of the path states, empty for the neighbors
+    std::vector<BlockingGraphs> parent_graphs;
+};
+
+// Takes the path states from the search itself rather than from the solution timeline, so they carry the exact
+// positions and symmetries the solver expanded
+template <size_t N, typename Occupancy>
+[[nodiscard]] RecordedStates record_states(const BurrPuzzleWizard<N, Occupancy>& wizard, BurrPuzzleWizardKernels<N, Occupancy>& kernels)
+{
+    RecordedStates recorded;
+    const auto& path = wizard.get_solution_path();
+
+    for (size_t step = 0; step + 1 < path.size(); step++) {
+        Node node = kernels.make_node(path[step]);
+        kernels.build_field(node);
+
+        auto neighbors = kernels.get_neighbor_nodes(node);
+        const size_t parent = recorded.states.size() + neighbors.size();
+
+        for (auto& neighbor : neighbors) {
+            recorded.children.push_back(recorded.states.size());
+            recorded.parents.push_back(parent);
+            recorded.states.push_back(std::move(neighbor));
+        }
+
+        recorded.parents.push_back(recorded.states.size());
+        recorded.states.push_back(std::move(node));
+    }
+
+    recorded.parent_graphs.resize(recorded.states.size());
+
+    for (size_t state = 0; state < recorded.states.size(); state++) {
+        if (recorded.parents[state] == state)
+            recorded.parent_graphs[state] = kernels.build_blocking_graphs(recorded.states[state]);
+    }
+
+    return recorded;
+}
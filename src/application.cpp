@@ -1,3 +1,5 @@
+#include <cfloat>
+#include <cmath>
 #include <stdexcept>
 #include <format>
 #include <vector>
@@ -9,6 +11,7 @@
 #include <imgui/imgui_impl_opengl3.h>
 
 #include "application.h"
+#include "profiler.h"
 
 Application::Application(uint32_t width, uint32_t height) noexcept : _width(width), _height(height), _camera(glm::vec3(0.5, 0.5f, 3.0f))
 {
@@ -71,43 +74,53 @@ void Application::_new_gui_frame() noexcept
     {
         ImGui::Begin("Debug");
         ImGui::Text("\nApplication framerate (frame time): %.0f FPS\t(%.0f ms)", 1.0f / _delta_time, _delta_time * 1000);
+
+        if (!_profile_summary.empty()) {
+            ImGui::Text("\nSolver Profile");
+            ImGui::TextUnformatted(_profile_summary.c_str());
+        }
         ImGui::End();
     }
 
     {
         ImGui::Begin("Control");
 
+        // The solver reads the puzzle from its own thread, so manual moves wait until it is done
+        ImGui::BeginDisabled(_solve_result.valid());
+
         ImGui::Text("\n");
-        for (size_t i = 0; i < _wizard.get_num_pieces(); i ++) {
+        for (size_t i = 0; i < _wizard->get_num_pieces(); i ++) {
 
             std::string s = std::to_string(i + 1) + ". Piece";
             
             if (ImGui::TreeNode(s.c_str())) {
                 if (ImGui::Button(" +x ")) {
-                    _wizard.move_piece(i, {1, 0, 0});
+                    _move_piece(i, {1, 0, 0});
                 }
                 ImGui::SameLine();
                 if (ImGui::Button(" -x ")) {
-                    _wizard.move_piece(i, {-1, 0, 0});
+                    _move_piece(i, {-1, 0, 0});
                 }
                 if (ImGui::Button(" +y ")) {
-                    _wizard.move_piece(i, {0, 1, 0});
+                    _move_piece(i, {0, 1, 0});
                 }
                 ImGui::SameLine();
                 if (ImGui::Button(" -y ")) {
-                    _wizard.move_piece(i, {0, -1, 0});
+                    _move_piece(i, {0, -1, 0});
                 }
                 if (ImGui::Button(" +z ")) {
-                    _wizard.move_piece(i, {0, 0, 1});
+                    _move_piece(i, {0, 0, 1});
                 }
                 ImGui::SameLine();
                 if (ImGui::Button(" -z ")) {
-                    _wizard.move_piece(i, {0, 0, -1});
+                    _move_piece(i, {0, 0, -1});
                 }
 
                 ImGui::TreePop();
             }
         }
+
+        ImGui::EndDisabled();
         
         ImGui::End();
     }
@@ -115,23 +128,41 @@ void Application::_new_gui_frame() noexcept
     {
         ImGui::Begin("Wizard");
 
-        if (!_wizard.is_solved()) {
+        if (_solve_result.valid()) {
+            ImGui::Text("\nSolving...");
+        } else if (!_wizard->is_solved()) {
+            if (_wizard->get_status() != SolveStatus::NotStarted)
+                ImGui::Text("%s", fmt::format("\nLast solve stopped: {}", to_string(_wizard->get_status())).c_str());
+
             ImGui::Text("\nSolve Puzzle");
-            if (ImGui::Button("Solve")) {
-                _wizard.solve();
-            }
+            if (ImGui::Button("Solve"))
+                _start_solve();
+            ImGui::SameLine();
+            if (ImGui::Button("Import Solution"))
+                _import_solution();
         } else {
-            ImGui::Text("%s", fmt::format("\nTime to get Solution: {:.2f} ms", _wizard.get_solve_time()).c_str());
-            ImGui::Text("%s", fmt::format("Nodes visited: {}", _wizard.get_nodes_visited()).c_str());
+            ImGui::Text("%s", fmt::format("\nTime to get Solution: {:.2f} ms", _wizard->get_solve_time()).c_str());
+            ImGui::Text("%s", fmt::format("Nodes visited: {}", _wizard->get_nodes_visited()).c_str());
 
             ImGui::Text("\n");
-            ImGui::Text("Explore Solution");
-            ImGui::SameLine();
-            ImGui::Text("%s", fmt::format("{} / {}", _wizard.get_current_solution_state(), _wizard.get_solution_size()).c_str());
 
-            if (ImGui::Button("Previous")) _wizard.set_solution_state(false);
-            ImGui::SameLine();
-            if (ImGui::Button("Next")) _wizard.set_solution_state(true);
+            if (!_player.is_loaded() && ImGui::Button("Replay Solution"))
+                _player.load(_wizard->get_solution());
+
+            if (ImGui::Button("Export Solution")) {
+                auto solution_path = std::filesystem::path(_puzzle_path).replace_extension(".solution");
+
+                if (!_wizard->get_solution().save(solution_path))
+                    fmt::println("Failed to write solution to {}", solution_path.string());
+            }
+        }
+
+        if (!_solve_result.valid() && _player.is_loaded())
+            _draw_solution_player();
+
+        if (_solve_result.valid() || _wizard->get_status() != SolveStatus::NotStarted) {
+            _draw_memory_usage();
+            _draw_search_statistics();
         }
 
         ImGui::End();
@@ -197,6 +228,149 @@ void Application::_process_mouse_scroll_input(const SDL_Event& e) noexcept
     _camera.process_mouse_scroll(delta_scroll);
 }
 
+void Application::_move_piece(size_t index, utils::int3 direction) noexcept
+{
+    // Manual moves continue from the displayed solution step and detach the playback
+    if (_player.is_loaded()) {
+        _wizard->set_positions(_player.get_step_positions());
+        _player.clear();
+    }
+
+    _wizard->move_piece(index, direction);
+}
+
+void Application::_start_solve() noexcept
+{
+    // An imported solution may show a different state than the solver field, solve what is on screen
+    if (_player.is_loaded()) {
+        _wizard->set_positions(_player.get_step_positions());
+        _player.clear();
+    }
+
+    _solve_result = std::async(std::launch::async, [this] {
+        const bool solved = _wizard->solve();
+        std::string profile_summary;
+
+#ifdef BURR_PUZZLE_WIZARD_PROFILE
+        // The profiler is thread local, so its summary is taken here and handed to the GUI thread with the result
+        profile_summary = Profiler::get().get_summary();
+#endif
+
+        return std::pair(solved, std::move(profile_summary));
+    });
+}
+
+void Application::_poll_solve() noexcept
+{
+    if (!_solve_result.valid() || _solve_result.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        return;
+
+    auto [solved, profile_summary] = _solve_result.get();
+    _profile_summary = std::move(profile_summary);
+
+    if (solved)
+        _player.load(_wizard->get_solution());
+}
+
+void Application::_import_solution() noexcept
+{
+    const auto solution_path = std::filesystem::path(_puzzle_path).replace_extension(".solution");
+    SolutionTimeline timeline;
+
+    if (!timeline.load(solution_path)) {
+        fmt::println("Failed to read solution from {}", solution_path.string());
+        return;
+    }
+
+    if (timeline.get_num_pieces() != _wizard->get_num_pieces()) {
+        fmt::println("Solution {} has {} pieces, the puzzle has {}", solution_path.string(), timeline.get_num_pieces(), _wizard->get_num_pieces());
+        return;
+    }
+
+    _player.load(std::move(timeline));
+}
+
+void Application::_draw_solution_player() noexcept
+{
+    ImGui::Text("Explore Solution");
+    ImGui::SameLine();
+    ImGui::Text("%s", fmt::format("{} / {}", _player.get_step(), _player.get_num_moves()).c_str());
+
+    if (ImGui::Button("Previous")) _player.seek(std::ceil(_player.get_time()) - 1.0f);
+    ImGui::SameLine();
+    if (_player.is_playing()) {
+        if (ImGui::Button("Pause")) _player.pause();
+    } else {
+        if (ImGui::Button("Play")) _player.play();
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Next")) _player.seek(std::floor(_player.get_time()) + 1.0f);
+
+    float time = _player.get_time();
+    if (ImGui::SliderFloat("Timeline", &time, 0.0f, static_cast<float>(_player.get_num_moves()), "%.2f"))
+        _player.seek(time);
+
+    float speed = _player.get_speed();
+    if (ImGui::SliderFloat("Moves / s", &speed, 0.1f, 50.0f, "%.1f", ImGuiSliderFlags_Logarithmic))
+        _player.set_speed(speed);
+
+    ImGui::Text("%s", fmt::format("Solution memory: {:.2f} KiB", static_cast<double>(_player.get_memory_usage()) / 1024).c_str());
+}
+
+void Application::_draw_memory_usage() const noexcept
+{
+    if (!ImGui::CollapsingHeader("Memory", ImGuiTreeNodeFlags_DefaultOpen))
+        return;
+
+    const MemoryUsage usage = _wizard->get_memory_usage();
+    auto mebibytes = [](size_t bytes) { return static_cast<double>(bytes) / (1 << 20); };
+
+    ImGui::Text("%s", fmt::format("Open list:    {:>10.2f} MiB", mebibytes(usage.open_list)).c_str());
+    ImGui::Text("%s", fmt::format("Closed set:   {:>10.2f} MiB", mebibytes(usage.closed_set)).c_str());
+    ImGui::Text("%s", fmt::format("State arena:  {:>10.2f} MiB", mebibytes(usage.state_arena)).c_str());
+    ImGui::Text("%s", fmt::format("Blocking:     {:>10.2f} MiB", mebibytes(usage.blocking_graphs)).c_str());
+    ImGui::Text("%s", fmt::format("Piece cache:  {:>10.2f} MiB", mebibytes(usage.piece_cache)).c_str());
+    ImGui::Text("%s", fmt::format("Total:        {:>10.2f} MiB (peak {:.2f} MiB)", mebibytes(usage.get_total()), mebibytes(usage.peak_total)).c_str());
+    ImGui::Text("%s", fmt::format("Bytes per state: {:.0f} ({} states)", usage.get_bytes_per_state(), usage.stored_states).c_str());
+}
+
+void Application::_draw_search_statistics() const noexcept
+{
+    if (!ImGui::CollapsingHeader("Search Statistics", ImGuiTreeNodeFlags_DefaultOpen))
+        return;
+
+    const SearchStatistics statistics = _wizard->get_search_statistics();
+
+    ImGui::Text("%s", fmt::format("Expansions: {} ({} repeated, {} reopened)", statistics.get_expansions(), statistics.get_reexpansions(), statistics.get_reopens()).c_str());
+    ImGui::Text("%s", fmt::format("Branching factor: {:.2f}", statistics.get_branching_factor()).c_str());
+    ImGui::Text("%s", fmt::format("Duplicate hits: {} / {} ({:.1f} %)", statistics.get_duplicates(), statistics.get_generated(), statistics.get_duplicate_rate() * 100.0).c_str());
+
+    auto plot_histogram = [](const char* label, const Histogram& histogram) {
+        std::vector<float> values;
+
+        for (uint64_t count : histogram.get_buckets()) {
+            values.push_back(static_cast<float>(count));
+        }
+
+        const std::string overlay = fmt::format("mean {:.2f}, max {}", histogram.get_mean(), histogram.get_max());
+        ImGui::PlotHistogram(label, values.data(), static_cast<int>(values.size()), 0, overlay.c_str(), 0.0f, FLT_MAX, ImVec2(0.0f, 60.0f));
+    };
+
+    plot_histogram("Neighbors", statistics.get_neighbors());
+    plot_histogram("Component Sizes", statistics.get_component_sizes());
+    plot_histogram("Slide Distances", statistics.get_slide_distances());
+    plot_histogram("Open Priorities", statistics.get_open_priorities());
+
+    std::vector<float> frontier;
+
+    for (size_t size : statistics.get_frontier_sizes()) {
+        frontier.push_back(static_cast<float>(size));
+    }
+
+    const std::string overlay = fmt::format("every {} expansions", statistics.get_frontier_sample_interval());
+    ImGui::PlotLines("Frontier Size", frontier.data(), static_cast<int>(frontier.size()), 0, overlay.c_str(), 0.0f, FLT_MAX, ImVec2(0.0f, 60.0f));
+}
+
 void Application::_render() const noexcept
 {
     glViewport(0, 0, _width, _height);
@@ -214,6 +388,7 @@ void Application::_render() const noexcept
     glUniformMatrix4fv(glGetUniformLocation(_shader_program, "u_proj"), 1, GL_FALSE, &proj[0][0]);
     glUniformMatrix4fv(glGetUniformLocation(_shader_program, "u_view"), 1, GL_FALSE, &view[0][0]);
     glUniform3fv(glGetUniformLocation(_shader_program, "u_color"), 1, &color[0]);
+    glUniform3f(glGetUniformLocation(_shader_program, "u_offset"), 0.0f, 0.0f, 0.0f);
 
     // Render Grid
     glBindVertexArray(_grid_vertex_array_object);
@@ -224,14 +399,16 @@ void Application::_render() const noexcept
     glUniform3f(glGetUniformLocation(_shader_program, "u_view_position"), camera_position.x, camera_position.y, camera_position.z);
     glUniform4f(glGetUniformLocation(_shader_program, "u_color"), 1.0f, 1.0f, 1.0f, 1.0f);
 
-    std::vector<std::vector<utils::int3>> unit_cube_positions = _wizard.get_all_unit_cube_global_positions();
-    
-    const float cube_scale = 1.0f / static_cast<float>(_wizard.get_dim());
+    const float cube_scale = 1.0f / static_cast<float>(_wizard->get_dim());
     
-    for (size_t piece = 0; piece < unit_cube_positions.size(); piece++) {
-        color = _wizard.get_color(piece);
+    for (size_t piece = 0; piece < _wizard->get_num_pieces(); piece++) {
+        color = _wizard->get_color(piece);
+
+        // Pieces are translated in the vertex shader, so playback only updates one uniform per piece
+        glm::vec3 offset = _player.is_loaded() ? _player.get_piece_offsets()[piece] : static_cast<glm::vec3>(_wizard->get_positions()[piece]);
+        glUniform3fv(glGetUniformLocation(_shader_program, "u_offset"), 1, &offset[0]);
         
-        for (const auto& cube_position : unit_cube_positions[piece]) {
+        for (const auto& cube_position : _wizard->get_unit_cube_positions(piece)) {
             model = glm::mat4(1.0f);
             model = glm::scale(model, {cube_scale, cube_scale, cube_scale});
             model = glm::translate(model, static_cast<glm::vec3>(cube_position));
@@ -256,6 +433,8 @@ void Application::run() noexcept
         _handle_sdl_events(e, running);
         _update_delta_time();
         _process_key_input(running);
+        _poll_solve();
+        _player.update(_delta_time);
         
         _new_gui_frame();
         _render();
@@ -267,9 +446,20 @@ void Application::run() noexcept
 
 void Application::init_wizard(const std::filesystem::path& filepath) noexcept
 {
-    _wizard.read_puzzle_from_file(filepath);
-    _wizard.init_field();
-    _wizard.init_start_node();
+    _puzzle_path = filepath;
+
+    std::vector<PuzzleParseError> errors;
+    std::unique_ptr<PuzzleSolver> wizard = open_puzzle(filepath, errors);
+
+    for (const auto& error : errors) {
+        fmt::println("{}:{}: {}", filepath.string(), error.line, error.message);
+    }
+
+    if (wizard)
+        _wizard = std::move(wizard);
+
+    _wizard->init_field();
+    _wizard->init_start_node();
 }
 
 void Application::_init_imgui() const noexcept
@@ -325,12 +515,14 @@ auto vertex_shader_source = R"(
     uniform mat4 u_proj;
     uniform mat4 u_view;
     uniform mat4 u_model;
+    uniform vec3 u_offset;
 
     void main() {
-        gl_Position = u_proj * u_view * u_model * position;
+        vec4 offset_position = position + vec4(u_offset, 0.0);
+        gl_Position = u_proj * u_view * u_model * offset_position;
         
         frag_normal = transpose(inverse(u_model)) * normal;
-        frag_position = u_model * position;
+        frag_position = u_model * offset_position;
     }
 )";
 
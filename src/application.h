@@ -1,10 +1,15 @@
 #pragma once
 
+#include <future>
+#include <memory>
+#include <string>
+#include <utility>
 #include <GL/glew.h>
 #include <SDL2/SDL.h>
 
 #include "camera.h"
-#include "burr_puzzle_wizard.h"
+#include "puzzle_solver.h"
+#include "solution_player.h"
 
 class Application final
 {
@@ -27,15 +32,25 @@ private:
     void _process_key_input(bool& running) noexcept;
     void _process_mouse_motion_input(const SDL_Event& e) noexcept;
     void _process_mouse_scroll_input(const SDL_Event& e) noexcept;
+    void _move_piece(size_t index, utils::int3 direction) noexcept;
+    void _start_solve() noexcept;
+    void _poll_solve() noexcept;
+    void _import_solution() noexcept;
+    void _draw_solution_player() noexcept;
+    void _draw_memory_usage() const noexcept;
+    void _draw_search_statistics() const noexcept;
 
     void _render() const noexcept;
     
     void _update_delta_time() noexcept;
     
 private:
-    // TODO: use ptr instead?
-    // TODO: templated class nested in non-templated class?
-    BurrPuzzleWizard<48> _wizard;
+    // Sized for the loaded puzzle, an empty solver on the largest grid until a puzzle loads
+    std::unique_ptr<PuzzleSolver> _wizard = create_puzzle_solver(supported_grid_sizes.back());
+    SolutionPlayer _player;
+    std::future<std::pair<bool, std::string>> _solve_result;
+    std::string _profile_summary;
+    std::filesystem::path _puzzle_path;
     
     uint32_t _width;
     uint32_t _height;
@@ -0,0 +1,644 @@
+#include "assembler.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <fmt/format.h>
+
+bool Assembler::load(const std::vector<std::vector<utils::int3>>& pieces, const std::vector<utils::int3>& target) noexcept
+{
+    *this = Assembler();
+
+    if (pieces.empty() || target.empty()) {
+        _error = "Assembly needs at least one piece and a non-empty target shape";
+        return false;
+    }
+
+    _grid = CellGrid(target);
+
+    size_t volume = 0;
+
+    for (const auto& piece : pieces) {
+        volume += piece.size();
+    }
+
+    _num_pieces = pieces.size();
+
+    if (volume > _grid.size()) {
+        _error = fmt::format("Pieces have {} unit cubes but the target shape only has {} cells", volume, _grid.size());
+        return false;
+    }
+
+    _num_holes = _grid.size() - volume;
+
+    // Pieces with the same canonical orientation are interchangeable in an assembly
+    for (size_t i = 0; i < pieces.size(); i++) {
+        if (pieces[i].empty()) {
+            _error = fmt::format("Piece {} has no unit cubes", i);
+            return false;
+        }
+
+        OrientationTable table(pieces[i]);
+
+        auto it = std::ranges::find_if(_classes, [&](const PieceClass& piece_class) { return piece_class.table.get_canonical().cubes == table.get_canonical().cubes; });
+
+        if (it != _classes.end())
+            it->pieces.push_back(i);
+        else
+            _classes.push_back({{i}, std::move(table), {}});
+    }
+
+    _find_symmetries();
+    _generate_placements();
+
+    return true;
+}
+
+size_t Assembler::assemble(const std::function<bool(const Assembly&)>& on_assembly) noexcept
+{
+    if (_grid.empty())
+        return 0;
+
+    ExactCover exact_cover = _build_exact_cover();
+
+    if (_threads > 1 || _on_progress)
+        return _assemble_parallel(exact_cover, on_assembly);
+
+    size_t count = 0;
+
+    exact_cover.search([&](const std::vector<int>& rows) {
+        if (!_is_canonical(rows))
+            return true;
+
+        count++;
+        return on_assembly(_make_assembly(rows));
+    });
+
+    _num_search_nodes = exact_cover.get_num_search_nodes();
+
+    return count;
+}
+
+void Assembler::set_threads(size_t threads) noexcept
+{
+    _threads = std::max<size_t>(threads, 1);
+}
+
+void Assembler::set_progress_callback(std::function<void(const AssemblyProgress&)> on_progress, std::chrono::milliseconds interval) noexcept
+{
+    _on_progress = std::move(on_progress);
+    _progress_interval = interval;
+}
+
+ExactCover Assembler::_build_exact_cover() const noexcept
+{
+    // Without holes every cell has to be filled, otherwise cells are optional and only the pieces are mandatory
+    const bool fill_cells = _num_holes == 0;
+
+    // Cells covered by exactly the same placements are always filled together and share one column,
+    // which keeps the rows short when pieces are built from larger blocks
+    std::vector<std::vector<int>> cell_rows(_grid.size());
+
+    for (size_t row = 0; row < _rows.size(); row++) {
+        for (int cell : _get_placement(_rows[row]).cells) {
+            cell_rows[static_cast<size_t>(cell)].push_back(static_cast<int>(row));
+        }
+    }
+
+    std::map<std::vector<int>, int> cell_groups;
+    std::vector<int> cell_columns(_grid.size());
+
+    for (size_t cell = 0; cell < _grid.size(); cell++) {
+        auto [it, inserted] = cell_groups.try_emplace(std::move(cell_rows[cell]), static_cast<int>(cell_groups.size()));
+        cell_columns[cell] = it->second;
+    }
+
+    const int num_cell_columns = static_cast<int>(cell_groups.size());
+    const int class_column_offset = fill_cells ? num_cell_columns : 0;
+    const int cell_column_offset = fill_cells ? 0 : static_cast<int>(_classes.size());
+
+    std::vector<uint32_t> multiplicities;
+
+    if (fill_cells)
+        multiplicities.assign(static_cast<size_t>(num_cell_columns), 1);
+
+    for (const auto& piece_class : _classes) {
+        multiplicities.push_back(static_cast<uint32_t>(piece_class.pieces.size()));
+    }
+
+    ExactCover exact_cover(std::move(multiplicities), fill_cells ? 0 : static_cast<size_t>(num_cell_columns));
+    std::vector<int> columns;
+
+    for (const auto& row : _rows) {
+        columns.clear();
+        columns.push_back(class_column_offset + static_cast<int>(row.piece_class));
+
+        for (int cell : _get_placement(row).cells) {
+            columns.push_back(cell_column_offset + cell_columns[static_cast<size_t>(cell)]);
+        }
+
+        std::sort(columns.begin() + 1, columns.end());
+        columns.erase(std::unique(columns.begin() + 1, columns.end()), columns.end());
+
+        exact_cover.add_row(columns);
+    }
+
+    return exact_cover;
+}
+
+size_t Assembler::_assemble_parallel(ExactCover& exact_cover, const std::function<bool(const Assembly&)>& on_assembly) noexcept
+{
+    struct TaskResult
+    {
+        std::vector<Assembly> assemblies;
+        uint64_t num_search_nodes = 0;
+        double estimated_nodes = -1.0;
+        bool done = false;
+    };
+
+    uint64_t num_split_nodes = 0;
+    const std::vector<std::vector<uint32_t>> tasks = _split_tasks(exact_cover, _threads * tasks_per_thread, num_split_nodes);
+    std::vector<TaskResult> results(tasks.size());
+
+    // Every worker owns a contiguous block of tasks and takes them front to back, which is search order, so
+    // results can be reported early. Idle workers steal from the front of the other queues, the lowest task
+    // left, so stolen work stays inside the window of tasks that may run ahead of the reported ones.
+    std::vector<std::deque<size_t>> queues(_threads);
+    std::vector<std::mutex> queue_mutexes(_threads);
+
+    for (size_t task = 0; task < tasks.size(); task++) {
+        queues[task * _threads / tasks.size()].push_back(task);
+    }
+
+    auto next_task = [&](size_t worker, size_t& task) {
+        {
+            std::scoped_lock lock(queue_mutexes[worker]);
+
+            if (!queues[worker].empty()) {
+                task = queues[worker].front();
+                queues[worker].pop_front();
+                return true;
+            }
+        }
+
+        for (size_t i = 1; i < _threads; i++) {
+            const size_t victim = (worker + i) % _threads;
+            std::scoped_lock lock(queue_mutexes[victim]);
+
+            if (!queues[victim].empty()) {
+                task = queues[victim].front();
+                queues[victim].pop_front();
+                return true;
+            }
+        }
+
+        return false;
+    };
+
+    // Finished tasks keep their assemblies until the calling thread reports them, so workers only start tasks
+    // within a window ahead of the next one to report. A slow on_assembly then bounds memory for any thread count.
+    const size_t max_pending_tasks = _threads * max_pending_tasks_per_thread;
+    size_t next = 0;
+
+    std::mutex result_mutex;
+    std::condition_variable result_ready;
+    std::condition_variable window_open;
+    std::atomic<bool> stop = false;
+    std::vector<std::thread> workers;
+
+    for (size_t worker = 0; worker < _threads; worker++) {
+        workers.emplace_back([&, worker] {
+            ExactCover cover = exact_cover;
+            cover.set_stop_flag(&stop);
+
+            size_t task;
+
+            while (!stop.load(std::memory_order_relaxed) && next_task(worker, task)) {
+                {
+                    std::unique_lock lock(result_mutex);
+                    window_open.wait(lock, [&] { return task < next + max_pending_tasks || stop; });
+                }
+
+                if (stop)
+                    break;
+
+                for (uint32_t branch : tasks[task]) {
+                    cover.descend(branch);
+                }
+
+                // Estimates only feed the progress report, without a listener the probes would be wasted work
+                if (_on_progress) {
+                    const double estimated_nodes = _estimate_subtree(cover, task);
+
+                    std::scoped_lock lock(result_mutex);
+                    results[task].estimated_nodes = estimated_nodes;
+                }
+
+                const uint64_t nodes_before = cover.get_num_search_nodes();
+                std::vector<Assembly> assemblies;
+
+                cover.search([&](const std::vector<int>& rows) {
+                    if (_is_canonical(rows))
+                        assemblies.push_back(_make_assembly(rows));
+
+                    return true;
+                });
+
+                for (size_t i = 0; i < tasks[task].size(); i++) {
+                    cover.ascend();
+                }
+
+                std::scoped_lock lock(result_mutex);
+                results[task].assemblies = std::move(assemblies);
+                results[task].num_search_nodes = cover.get_num_search_nodes() - nodes_before;
+                results[task].done = true;
+                result_ready.notify_one();
+            }
+        });
+    }
+
+    auto get_progress = [&](size_t count) {
+        AssemblyProgress progress = {0, tasks.size(), num_split_nodes, 0.0, count};
+        double known_estimates = 0.0;
+        size_t num_known_estimates = 0;
+        size_t num_unknown_estimates = 0;
+
+        for (const auto& result : results) {
+            if (result.estimated_nodes >= 0.0) {
+                known_estimates += result.estimated_nodes;
+                num_known_estimates++;
+            }
+
+            if (result.done) {
+                progress.tasks_done++;
+                progress.nodes_searched += result.num_search_nodes;
+            } else if (result.estimated_nodes >= 0.0) {
+                progress.estimated_nodes_remaining += result.estimated_nodes;
+            } else {
+                num_unknown_estimates++;
+            }
+        }
+
+        // Tasks that have not started yet are assumed to be as large as the average task so far
+        if (num_known_estimates > 0)
+            progress.estimated_nodes_remaining += known_estimates / static_cast<double>(num_known_estimates) * static_cast<double>(num_unknown_estimates);
+
+        return progress;
+    };
+
+    // Results are reported in task order on the calling thread, so the assemblies and their order match the
+    // sequential search no matter how many threads run or who steals what
+    size_t count = 0;
+    auto last_progress = std::chrono::steady_clock::now();
+
+    std::unique_lock lock(result_mutex);
+
+    while (next < tasks.size() && !stop) {
+        result_ready.wait_for(lock, _progress_interval, [&] { return results[next].done; });
+
+        while (next < tasks.size() && results[next].done && !stop) {
+            std::vector<Assembly> assemblies = std::move(results[next++].assemblies);
+            lock.unlock();
+            window_open.notify_all();
+
+            for (const auto& assembly : assemblies) {
+                count++;
+
+                if (!on_assembly(assembly)) {
+                    stop = true;
+                    break;
+                }
+            }
+
+            lock.lock();
+        }
+
+        if (_on_progress && std::chrono::steady_clock::now() - last_progress >= _progress_interval) {
+            const AssemblyProgress progress = get_progress(count);
+            last_progress = std::chrono::steady_clock::now();
+
+            lock.unlock();
+            _on_progress(progress);
+            lock.lock();
+        }
+    }
+
+    // Set under the lock, so a worker checking the window either sees it or is already waiting for the notify
+    stop = true;
+    lock.unlock();
+    window_open.notify_all();
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    const AssemblyProgress progress = get_progress(count);
+    _num_search_nodes = progress.nodes_searched;
+
+    if (_on_progress)
+        _on_progress(progress);
+
+    return count;
+}
+
+std::vector<std::vector<uint32_t>> Assembler::_split_tasks(ExactCover& exact_cover, size_t min_tasks, uint64_t& num_split_nodes) const noexcept
+{
+    std::vector<std::vector<uint32_t>> tasks;
+
+    // Deepens the split until there are enough subtrees to balance, dead ends are dropped on the way
+    for (size_t depth = 1; depth <= max_split_depth; depth++) {
+        std::vector<uint32_t> path;
+        tasks.clear();
+        num_split_nodes = 0;
+
+        auto collect = [&](auto& self, size_t remaining_depth) -> void {
+            const size_t branches = exact_cover.get_num_branches();
+
+            // Counted like search() counts them, the roots of the tasks are counted by their own search
+            if (!exact_cover.is_solved() && (remaining_depth > 0 || branches == 0))
+                num_split_nodes++;
+
+            if (remaining_depth == 0 || branches == 0) {
+                if (branches > 0 || exact_cover.is_solved())
+                    tasks.push_back(path);
+
+                return;
+            }
+
+            for (size_t branch = 0; branch < branches; branch++) {
+                exact_cover.descend(branch);
+                path.push_back(static_cast<uint32_t>(branch));
+
+                self(self, remaining_depth - 1);
+
+                path.pop_back();
+                exact_cover.ascend();
+            }
+        };
+
+        collect(collect, depth);
+
+        if (tasks.size() >= min_tasks)
+            break;
+    }
+
+    return tasks;
+}
+
+double Assembler::_estimate_subtree(ExactCover& exact_cover, uint64_t seed) const noexcept
+{
+    // Knuth's estimator: the product of the branching factors along a random path is an unbiased estimate
+    // of the number of nodes on that level, averaged over a few probes
+    std::mt19937_64 random(seed);
+    double total = 0.0;
+
+    for (size_t probe = 0; probe < estimate_probes; probe++) {
+        double level_nodes = 1.0;
+        double estimate = 1.0;
+        size_t depth = 0;
+
+        for (size_t branches = exact_cover.get_num_branches(); branches > 0; branches = exact_cover.get_num_branches()) {
+            level_nodes *= static_cast<double>(branches);
+            estimate += level_nodes;
+
+            exact_cover.descend(random() % branches);
+            depth++;
+        }
+
+        for (size_t i = 0; i < depth; i++) {
+            exact_cover.ascend();
+        }
+
+        total += estimate;
+    }
+
+    return total / static_cast<double>(estimate_probes);
+}
+
+std::vector<utils::int3> Assembler::get_shape(const std::vector<std::vector<utils::int3>>& pieces, const std::vector<utils::int3>& positions) noexcept
+{
+    std::vector<utils::int3> shape;
+
+    for (size_t i = 0; i < pieces.size(); i++) {
+        for (const auto& cube : pieces[i]) {
+            shape.push_back(cube + positions[i]);
+        }
+    }
+
+    orientation::sort_grid_order(shape);
+    shape.erase(std::unique(shape.begin(), shape.end()), shape.end());
+
+    return shape;
+}
+
+size_t Assembler::get_num_classes() const noexcept
+{
+    return _classes.size();
+}
+
+size_t Assembler::get_num_placements() const noexcept
+{
+    return _rows.size();
+}
+
+size_t Assembler::get_num_symmetries() const noexcept
+{
+    return _symmetries.size();
+}
+
+uint64_t Assembler::get_num_search_nodes() const noexcept
+{
+    return _num_search_nodes;
+}
+
+const std::string& Assembler::get_error() const noexcept
+{
+    return _error;
+}
+
+const Placement& Assembler::_get_placement(const Row& row) const noexcept
+{
+    return _classes[row.piece_class].placements.get_placements()[row.placement];
+}
+
+void Assembler::_find_symmetries() noexcept
+{
+    const auto& rotations = orientation::get_rotations();
+    const std::vector<utils::int3>& cells = _grid.get_cells();
+    const OrientationTable table(cells);
+
+    for (uint8_t r : table.get_symmetry_group()) {
+        std::vector<utils::int3> rotated;
+
+        for (const auto& cell : cells) {
+            rotated.push_back(orientation::rotate(rotations[r], cell));
+        }
+
+        const utils::int3 min = orientation::get_min(rotated);
+        const utils::int3 grid_min = _grid.get_min();
+        std::vector<int> permutation;
+
+        for (const auto& cell : rotated) {
+            permutation.push_back(_grid.get_index({cell.x - min.x + grid_min.x, cell.y - min.y + grid_min.y, cell.z - min.z + grid_min.z}));
+        }
+
+        _symmetries.push_back(std::move(permutation));
+    }
+}
+
+void Assembler::_generate_placements() noexcept
+{
+    for (size_t c = 0; c < _classes.size(); c++) {
+        _classes[c].placements = PlacementIndex(_classes[c].table, _grid);
+
+        for (size_t i = 0; i < _classes[c].placements.size(); i++) {
+            _rows.push_back({static_cast<uint32_t>(c), static_cast<uint32_t>(i)});
+        }
+    }
+
+    if (_symmetries.size() < 2)
+        return;
+
+    // Symmetric images of an assembly are found from every image of its pieces. Restricting one unique piece
+    // to the smallest placement of each symmetry orbit removes most of them before the search even starts.
+    size_t pivot = _classes.size();
+    size_t pivot_placements = 0;
+
+    for (size_t c = 0; c < _classes.size(); c++) {
+        const size_t count = _classes[c].placements.size();
+
+        if (_classes[c].pieces.size() == 1 && count > pivot_placements) {
+            pivot = c;
+            pivot_placements = count;
+        }
+    }
+
+    if (pivot == _classes.size())
+        return;
+
+    _pivot_class = pivot;
+
+    std::erase_if(_rows, [&](const Row& row) {
+        if (row.piece_class != pivot)
+            return false;
+
+        const std::vector<int>& cells = _get_placement(row).cells;
+
+        for (const auto& symmetry : _symmetries) {
+            std::vector<int> image;
+
+            for (int cell : cells) {
+                image.push_back(symmetry[static_cast<size_t>(cell)]);
+            }
+
+            std::ranges::sort(image);
+
+            if (image < cells)
+                return true;
+        }
+
+        return false;
+    });
+}
+
+std::vector<int> Assembler::_get_representation(const std::vector<int>& rows, size_t symmetry) const noexcept
+{
+    std::vector<std::vector<int>> placements;
+
+    for (int row : rows) {
+        const Row& entry_row = _rows[static_cast<size_t>(row)];
+        std::vector<int> entry = {static_cast<int>(entry_row.piece_class)};
+
+        for (int cell : _get_placement(entry_row).cells) {
+            entry.push_back(_symmetries[symmetry][static_cast<size_t>(cell)]);
+        }
+
+        std::sort(entry.begin() + 1, entry.end());
+        placements.push_back(std::move(entry));
+    }
+
+    std::ranges::sort(placements);
+
+    std::vector<int> representation;
+
+    for (const auto& entry : placements) {
+        representation.insert(representation.end(), entry.begin(), entry.end());
+    }
+
+    return representation;
+}
+
+bool Assembler::_is_canonical(const std::vector<int>& rows) const noexcept
+{
+    if (_symmetries.size() < 2)
+        return true;
+
+    // With a pivot only the images that keep its placement minimal are candidates for the canonical assembly,
+    // the pruned placements guarantee that every symmetry orbit contains one of them
+    const std::vector<int>* pivot_cells = nullptr;
+
+    for (int row : rows) {
+        if (_rows[static_cast<size_t>(row)].piece_class == _pivot_class)
+            pivot_cells = &_get_placement(_rows[static_cast<size_t>(row)]).cells;
+    }
+
+    const std::vector<int> representation = _get_representation(rows, 0);
+
+    for (size_t symmetry = 1; symmetry < _symmetries.size(); symmetry++) {
+        if (pivot_cells) {
+            std::vector<int> image;
+
+            for (int cell : *pivot_cells) {
+                image.push_back(_symmetries[symmetry][static_cast<size_t>(cell)]);
+            }
+
+            std::ranges::sort(image);
+
+            if (image != *pivot_cells)
+                continue;
+        }
+
+        if (_get_representation(rows, symmetry) < representation)
+            return false;
+    }
+
+    return true;
+}
+
+Assembly Assembler::_make_assembly(std::vector<int> rows) const noexcept
+{
+    std::ranges::sort(rows);
+
+    Assembly assembly;
+    assembly.pieces.resize(_num_pieces);
+    assembly.positions.resize(_num_pieces);
+
+    // Identical pieces take the placements in row order
+    std::vector<size_t> used(_classes.size(), 0);
+
+    for (int row : rows) {
+        const Row& entry = _rows[static_cast<size_t>(row)];
+        const size_t piece = _classes[entry.piece_class].pieces[used[entry.piece_class]++];
+
+        std::vector<utils::int3> cubes;
+
+        for (int cell : _get_placement(entry).cells) {
+            cubes.push_back(_grid.get_cells()[static_cast<size_t>(cell)]);
+        }
+
+        const utils::int3 min = orientation::get_min(cubes);
+
+        for (auto& cube : cubes) {
+            cube = {cube.x - min.x, cube.y - min.y, cube.z - min.z};
+        }
+
+        assembly.pieces[piece] = std::move(cubes);
+        assembly.positions[piece] = min;
+    }
+
+    return assembly;
+}
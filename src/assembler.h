@@ -0,0 +1,109 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "exact_cover.h"
+#include "orientation_table.h"
+#include "placement_index.h"
+#include "utils.h"
+
+// Pieces in the orientation they take in the assembly, placed like the pieces of a puzzle file,
+// so an assembly can be handed to BurrPuzzleWizard<N>::load_puzzle directly
+struct Assembly
+{
+    std::vector<std::vector<utils::int3>> pieces;
+    std::vector<utils::int3> positions;
+};
+
+struct AssemblyProgress
+{
+    size_t tasks_done = 0;
+    size_t tasks_total = 0;
+    uint64_t nodes_searched = 0;
+    double estimated_nodes_remaining = 0.0;
+    size_t assemblies = 0;
+};
+
+// Finds every way to assemble a piece set into a target shape as an exact cover problem: one column per
+// target cell and one per class of identical pieces, one row per placement of a class in any of the 24
+// rotations. Targets larger than the pieces leave holes. Assemblies that are rotations of each other
+// because of a symmetric target are only reported once.
+class Assembler final
+{
+public:
+    Assembler() = default;
+
+    [[nodiscard]] bool load(const std::vector<std::vector<utils::int3>>& pieces, const std::vector<utils::int3>& target) noexcept;
+
+    // Calls on_assembly for every assembly until it returns false, returns the number of assemblies reported.
+    // The callback runs on the calling thread and sees the same assemblies in the same order for any thread count.
+    size_t assemble(const std::function<bool(const Assembly&)>& on_assembly) noexcept;
+
+    // With more than one thread the search tree is split into subtrees at a shallow depth that run on a work stealing pool
+    void set_threads(size_t threads) noexcept;
+    void set_progress_callback(std::function<void(const AssemblyProgress&)> on_progress, std::chrono::milliseconds interval = std::chrono::milliseconds(1000)) noexcept;
+
+    // Union of the unit cubes of all pieces at their positions, e.g. the assembled shape of a puzzle file
+    [[nodiscard]] static std::vector<utils::int3> get_shape(const std::vector<std::vector<utils::int3>>& pieces, const std::vector<utils::int3>& positions) noexcept;
+
+    [[nodiscard]] size_t get_num_classes() const noexcept;
+    [[nodiscard]] size_t get_num_placements() const noexcept;
+    [[nodiscard]] size_t get_num_symmetries() const noexcept;
+    [[nodiscard]] uint64_t get_num_search_nodes() const noexcept;
+    [[nodiscard]] const std::string& get_error() const noexcept;
+
+private:
+    struct PieceClass
+    {
+        std::vector<size_t> pieces;
+        OrientationTable table;
+        PlacementIndex placements;
+    };
+
+    // Row of the exact cover: a placement of a piece class
+    struct Row
+    {
+        uint32_t piece_class;
+        uint32_t placement;
+    };
+
+    static constexpr size_t tasks_per_thread = 16;
+    static constexpr size_t max_pending_tasks_per_thread = 4;
+    static constexpr size_t max_split_depth = 8;
+    static constexpr size_t estimate_probes = 2;
+
+    [[nodiscard]] ExactCover _build_exact_cover() const noexcept;
+    size_t _assemble_parallel(ExactCover& exact_cover, const std::function<bool(const Assembly&)>& on_assembly) noexcept;
+    [[nodiscard]] std::vector<std::vector<uint32_t>> _split_tasks(ExactCover& exact_cover, size_t min_tasks, uint64_t& num_split_nodes) const noexcept;
+    [[nodiscard]] double _estimate_subtree(ExactCover& exact_cover, uint64_t seed) const noexcept;
+
+    [[nodiscard]] const Placement& _get_placement(const Row& row) const noexcept;
+    void _find_symmetries() noexcept;
+    void _generate_placements() noexcept;
+    [[nodiscard]] std::vector<int> _get_representation(const std::vector<int>& rows, size_t symmetry) const noexcept;
+    [[nodiscard]] bool _is_canonical(const std::vector<int>& rows) const noexcept;
+    [[nodiscard]] Assembly _make_assembly(std::vector<int> rows) const noexcept;
+
+private:
+    CellGrid _grid;
+    size_t _num_pieces = 0;
+    size_t _num_holes = 0;
+
+    std::vector<PieceClass> _classes;
+    std::vector<Row> _rows;
+
+    // Cell permutations of the rotations that map the target onto itself, the identity included
+    std::vector<std::vector<int>> _symmetries;
+    size_t _pivot_class = SIZE_MAX;
+
+    size_t _threads = 1;
+    std::function<void(const AssemblyProgress&)> _on_progress;
+    std::chrono::milliseconds _progress_interval = std::chrono::milliseconds(1000);
+
+    uint64_t _num_search_nodes = 0;
+    std::string _error;
+};
@@ -0,0 +1,198 @@
+#include "binary_puzzle.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <fmt/format.h>
+
+#include "puzzle_parser.h"
+
+static_assert(std::endian::native == std::endian::little, "BinaryPuzzle assumes a little-endian host");
+
+namespace
+{
+    constexpr char magic[4] = {'B', 'P', 'W', 'P'};
+
+    size_t align(size_t offset)
+    {
+        return (offset + 7) & ~size_t(7);
+    }
+
+    // Start positions are bounded like those of text puzzles, so grid sizes derived from them cannot overflow
+    bool is_valid_position(int32_t x, int32_t y, int32_t z)
+    {
+        return x >= 0 && y >= 0 && z >= 0 && x < max_puzzle_coordinate && y < max_puzzle_coordinate && z < max_puzzle_coordinate;
+    }
+}
+
+bool BinaryPuzzle::open(const std::filesystem::path& path) noexcept
+{
+    _header = nullptr;
+
+    if (!_file.open(path))
+        return _fail(fmt::format("Could not map {}", path.string()));
+
+    return _validate();
+}
+
+size_t BinaryPuzzle::get_num_pieces() const noexcept
+{
+    return _pieces.size();
+}
+
+const BinaryPieceRecord& BinaryPuzzle::get_piece(size_t index) const noexcept
+{
+    return _pieces[index];
+}
+
+std::span<const BinaryUnitCube> BinaryPuzzle::get_unit_cubes(size_t index) const noexcept
+{
+    return _unit_cubes.subspan(_pieces[index].first_unit_cube, _pieces[index].num_unit_cubes);
+}
+
+std::vector<utils::int3> BinaryPuzzle::get_unit_cube_positions(size_t index) const noexcept
+{
+    std::vector<utils::int3> positions;
+    positions.reserve(_pieces[index].num_unit_cubes);
+
+    for (const auto& cube : get_unit_cubes(index)) {
+        positions.push_back({cube.x, cube.y, cube.z});
+    }
+
+    return positions;
+}
+
+utils::int3 BinaryPuzzle::get_position(size_t index) const noexcept
+{
+    const auto& position = _pieces[index].position;
+    return {position[0], position[1], position[2]};
+}
+
+const std::string& BinaryPuzzle::get_error() const noexcept
+{
+    return _error;
+}
+
+bool BinaryPuzzle::write(const std::filesystem::path& path, const std::vector<std::vector<utils::int3>>& pieces, const std::vector<utils::int3>& positions) noexcept
+{
+    if (pieces.size() != positions.size() || pieces.size() > 64)
+        return false;
+
+    std::vector<BinaryPieceRecord> records;
+    std::vector<BinaryUnitCube> unit_cubes;
+
+    for (size_t i = 0; i < pieces.size(); i++) {
+        for (const auto& cube : pieces[i]) {
+            if (cube.x < 0 || cube.y < 0 || cube.z < 0 || cube.x > 255 || cube.y > 255 || cube.z > 255)
+                return false;
+        }
+
+        if (!is_valid_position(positions[i].x, positions[i].y, positions[i].z))
+            return false;
+
+        BinaryPieceRecord record = {};
+        record.position[0] = positions[i].x;
+        record.position[1] = positions[i].y;
+        record.position[2] = positions[i].z;
+        record.first_unit_cube = static_cast<uint32_t>(unit_cubes.size());
+        record.num_unit_cubes = static_cast<uint32_t>(pieces[i].size());
+
+        for (const auto& cube : pieces[i]) {
+            unit_cubes.push_back({static_cast<uint8_t>(cube.x), static_cast<uint8_t>(cube.y), static_cast<uint8_t>(cube.z), 0});
+        }
+
+        records.push_back(record);
+    }
+
+    BinaryPuzzleHeader header = {};
+    std::memcpy(header.magic, magic, sizeof(magic));
+    header.version = version;
+    header.num_pieces = static_cast<uint32_t>(records.size());
+    header.piece_table_offset = static_cast<uint32_t>(align(sizeof(header)));
+    header.unit_cube_offset = static_cast<uint32_t>(align(header.piece_table_offset + records.size() * sizeof(BinaryPieceRecord)));
+
+    std::ofstream stream(path, std::ios::binary);
+
+    if (!stream.is_open())
+        return false;
+
+    auto write_section = [&stream](size_t offset, const void* data, size_t size) {
+        while (static_cast<size_t>(stream.tellp()) < offset)
+            stream.put(0);
+
+        stream.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+    };
+
+    write_section(0, &header, sizeof(header));
+    write_section(header.piece_table_offset, records.data(), records.size() * sizeof(BinaryPieceRecord));
+    write_section(header.unit_cube_offset, unit_cubes.data(), unit_cubes.size() * sizeof(BinaryUnitCube));
+
+    return stream.good();
+}
+
+bool BinaryPuzzle::_validate() noexcept
+{
+    const std::byte* data = _file.data();
+    const size_t size = _file.size();
+
+    if (size < sizeof(BinaryPuzzleHeader))
+        return _fail("File is too small for a puzzle header");
+
+    const auto* header = reinterpret_cast<const BinaryPuzzleHeader*>(data);
+
+    if (std::memcmp(header->magic, magic, sizeof(magic)) != 0)
+        return _fail("Not a binary puzzle file");
+
+    if (header->version != version)
+        return _fail(fmt::format("Unsupported binary puzzle version {}", header->version));
+
+    if (header->num_pieces == 0 || header->num_pieces > 64)
+        return _fail(fmt::format("Invalid number of pieces {}", header->num_pieces));
+
+    auto section_fits = [size](size_t offset, size_t bytes) {
+        return offset % 8 == 0 && offset <= size && bytes <= size - offset;
+    };
+
+    if (!section_fits(header->piece_table_offset, header->num_pieces * sizeof(BinaryPieceRecord)))
+        return _fail("Piece table is out of bounds");
+
+    if (!section_fits(header->unit_cube_offset, 0))
+        return _fail("Unit cube section is out of bounds");
+
+    const auto* records = reinterpret_cast<const BinaryPieceRecord*>(data + header->piece_table_offset);
+    const size_t available_unit_cubes = (size - header->unit_cube_offset) / sizeof(BinaryUnitCube);
+    size_t num_unit_cubes = 0;
+
+    // Ranges are summed in size_t, a record near the uint32_t limit must not wrap back into the section
+    for (size_t i = 0; i < header->num_pieces; i++) {
+        const size_t end = size_t(records[i].first_unit_cube) + records[i].num_unit_cubes;
+
+        if (end > available_unit_cubes)
+            return _fail(fmt::format("Unit cubes of piece {} are out of bounds", i));
+
+        const auto& position = records[i].position;
+
+        if (!is_valid_position(position[0], position[1], position[2]))
+            return _fail(fmt::format("Start position of piece {} is outside of [0, {})", i, max_puzzle_coordinate));
+
+        num_unit_cubes = std::max(num_unit_cubes, end);
+    }
+
+    _header = header;
+    _pieces = {records, header->num_pieces};
+    _unit_cubes = {reinterpret_cast<const BinaryUnitCube*>(data + header->unit_cube_offset), num_unit_cubes};
+    _error.clear();
+
+    return true;
+}
+
+bool BinaryPuzzle::_fail(std::string error) noexcept
+{
+    _header = nullptr;
+    _pieces = {};
+    _unit_cubes = {};
+    _error = std::move(error);
+
+    return false;
+}
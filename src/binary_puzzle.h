@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "mapped_file.h"
+#include "utils.h"
+
+// On-disk layout of .bpz puzzles. All sections are 8 byte aligned little-endian arrays,
+// so a mapped file is used in place without any parsing.
+struct BinaryPuzzleHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t num_pieces;
+    uint32_t reserved;
+    uint32_t piece_table_offset;
+    uint32_t unit_cube_offset;
+};
+
+struct BinaryPieceRecord
+{
+    int32_t position[3];
+    uint32_t first_unit_cube;
+    uint32_t num_unit_cubes;
+    uint32_t reserved;
+};
+
+struct BinaryUnitCube
+{
+    uint8_t x, y, z, reserved;
+};
+
+static_assert(sizeof(BinaryPuzzleHeader) == 24);
+static_assert(sizeof(BinaryPieceRecord) == 24);
+static_assert(sizeof(BinaryUnitCube) == 4);
+
+class BinaryPuzzle final
+{
+public:
+    static constexpr uint32_t version = 2;
+
+    BinaryPuzzle() = default;
+
+    [[nodiscard]] bool open(const std::filesystem::path& path) noexcept;
+
+    [[nodiscard]] size_t get_num_pieces() const noexcept;
+    [[nodiscard]] const BinaryPieceRecord& get_piece(size_t index) const noexcept;
+    [[nodiscard]] std::span<const BinaryUnitCube> get_unit_cubes(size_t index) const noexcept;
+    [[nodiscard]] std::vector<utils::int3> get_unit_cube_positions(size_t index) const noexcept;
+    [[nodiscard]] utils::int3 get_position(size_t index) const noexcept;
+
+    [[nodiscard]] const std::string& get_error() const noexcept;
+
+    [[nodiscard]] static bool write(const std::filesystem::path& path, const std::vector<std::vector<utils::int3>>& pieces, const std::vector<utils::int3>& positions) noexcept;
+
+private:
+    [[nodiscard]] bool _validate() noexcept;
+    [[nodiscard]] bool _fail(std::string error) noexcept;
+
+private:
+    MappedFile _file;
+    std::string _error;
+
+    const BinaryPuzzleHeader* _header = nullptr;
+    std::span<const BinaryPieceRecord> _pieces;
+    std::span<const BinaryUnitCube> _unit_cubes;
+};
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "utils.h"
+
+// Blocking graphs of a state for the six unit directions: bit j of get_blockers(d, i) is set when piece i
+// moving by direction d would overlap piece j
+class BlockingGraphs final
+{
+public:
+    static constexpr size_t max_pieces = 64;
+
+    static constexpr std::array<utils::int3, 6> directions = {{{-1, 0, 0}, {1, 0, 0}, {0, -1, 0}, {0, 1, 0}, {0, 0, -1}, {0, 0, 1}}};
+
+    // Directions come in pairs of opposites
+    [[nodiscard]] static constexpr size_t get_opposite(size_t direction) noexcept
+    {
+        return direction ^ 1;
+    }
+
+    void reset(size_t num_pieces) noexcept
+    {
+        _num_pieces = num_pieces;
+        _rows.assign(directions.size() * num_pieces, 0);
+    }
+
+    [[nodiscard]] uint64_t get_blockers(size_t direction, size_t piece) const noexcept
+    {
+        return _rows[direction * _num_pieces + piece];
+    }
+
+    void set_blockers(size_t direction, size_t piece, uint64_t blockers) noexcept
+    {
+        _rows[direction * _num_pieces + piece] = blockers;
+    }
+
+    void set_blocker(size_t direction, size_t piece, size_t blocker) noexcept
+    {
+        _rows[direction * _num_pieces + piece] |= uint64_t(1) << blocker;
+    }
+
+    // Drops every edge from and to the pieces of a mask
+    void remove_pieces(uint64_t pieces) noexcept
+    {
+        for (size_t i = 0; i < _num_pieces; i++) {
+            const uint64_t kept = (pieces >> i) & 1 ? 0 : ~pieces;
+
+            for (size_t direction = 0; direction < directions.size(); direction++) {
+                _rows[direction * _num_pieces + i] &= kept;
+            }
+        }
+    }
+
+    [[nodiscard]] size_t get_heap_usage() const noexcept
+    {
+        return _rows.capacity() * sizeof(uint64_t) + utils::allocation_overhead;
+    }
+
+private:
+    size_t _num_pieces = 0;
+    std::vector<uint64_t> _rows;
+};
@@ -1,15 +1,32 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <deque>
 #include <filesystem>
-#include <sstream>
-#include <fstream>
+#include <limits>
+#include <mutex>
 #include <queue>
 #include <ranges>
-#include <stack>
-#include <unordered_set>
-
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <fmt/format.h>
+
+#include "binary_puzzle.h"
+#include "blocking_graph.h"
+#include "contact_index.h"
 #include "node.h"
-#include "piece.h"
+#include "dense_occupancy.h"
+#include "profiler.h"
+#include "puzzle_parser.h"
+#include "puzzle_solver.h"
+#include "sparse_occupancy.h"
+#include "search_statistics.h"
+#include "solution_timeline.h"
+#include "solve_status.h"
 #include "utils.h"
 
 namespace std
@@ -53,258 +70,876 @@ namespace std
     };
 }
 
-template <size_t N>
-class BurrPuzzleWizard final
+template <size_t N, typename Occupancy>
+class BurrPuzzleWizardKernels;
+
+// Occupancy supplies the piece and field types, DenseOccupancy<N> or SparseOccupancy
+template <size_t N, typename Occupancy = DenseOccupancy<N>>
+class BurrPuzzleWizard final : public PuzzleSolver
 {
+    // Lets the kernel microbenchmarks drive the private search primitives in isolation
+    friend class BurrPuzzleWizardKernels<N, Occupancy>;
+
 public:
     BurrPuzzleWizard() = default;
 
-    void read_puzzle_from_file(const std::filesystem::path& path) noexcept
+    bool read_puzzle_from_file(const std::filesystem::path& path) noexcept override
     {
-        std::bitset<N*N*N> temp_piece;
-        std::vector<Piece<N>> temp_pieces;
-        std::vector<utils::int3> temp_initial_positions;
+        if (path.extension() == ".bpz")
+            return _read_binary_puzzle(path);
 
-        std::ifstream stream(path);
+        PuzzleParser parser(static_cast<int>(N));
 
-        if (stream.is_open()) {
-            std::string line;
+        if (!parser.parse_file(path)) {
+            _load_errors = parser.get_errors();
+            return false;
+        }
 
-            while (getline(stream, line)) {
+        return load_puzzle(parser.get_pieces(), parser.get_positions());
+    }
 
-                // line[0] != '\r' for macOS
-                if (!line.empty() && line[0] != '\r') {
-                    std::vector<int> coordinates;
+    // Loads pieces given as unit cube lists, e.g. generated puzzles or found assemblies
+    bool load_puzzle(const std::vector<std::vector<utils::int3>>& pieces, const std::vector<utils::int3>& positions) noexcept override
+    {
+        if (pieces.size() > BlockingGraphs::max_pieces) {
+            _load_errors = {{0, fmt::format("Puzzle has {} pieces, at most {} are supported", pieces.size(), BlockingGraphs::max_pieces)}};
+            return false;
+        }
 
-                    std::istringstream iss(line);
-                    std::string word;
-                    
-                    if (line.at(0) == '#') {
-                        while (iss >> word) {
-                            if (word != "#") {
-                                coordinates.push_back(stoi(word));
-                            }
-                        }
+        if (positions.size() != pieces.size()) {
+            _load_errors = {{0, fmt::format("Puzzle has {} pieces but {} start positions", pieces.size(), positions.size())}};
+            return false;
+        }
 
-                        temp_initial_positions.push_back({coordinates[0], coordinates[1], coordinates[2]});
-                    } else {
-                        while (iss >> word) {
-                            coordinates.push_back(stoi(word));
-                        }
+        for (size_t i = 0; i < pieces.size(); i++) {
+            for (const auto& cube : pieces[i]) {
+                utils::int3 global = cube + positions[i];
 
-                        int index = utils::transform_index_3d_to_1d(coordinates[0], coordinates[1], coordinates[2], N);
-                        temp_piece[index] = 1;
+                for (size_t axis = 0; axis < 3; axis++) {
+                    if (cube[axis] < 0 || global[axis] < 0 || global[axis] >= static_cast<int>(N)) {
+                        _load_errors = {{0, fmt::format("Piece {} does not fit into a grid of size {} at its start position", i, N)}};
+                        return false;
                     }
-                } else {
-                    temp_pieces.push_back(temp_piece);
-                    temp_piece.reset();
                 }
             }
         }
 
-        _num_pieces = temp_pieces.size();
-        _puzzle = temp_pieces;
-        _initial_positions = temp_initial_positions;
-        _positions = temp_initial_positions;
+        _puzzle.clear();
+        _extents.clear();
+
+        for (const auto& unit_cubes : pieces) {
+            _puzzle.emplace_back(unit_cubes);
+            _extents.push_back(_get_extent(unit_cubes));
+        }
 
-        stream.close();
+        _num_pieces = _puzzle.size();
+        _scratch.contacts.reserve(_num_pieces);
+        _scratch.new_positions.reserve(_num_pieces);
+        _scratch.components.reserve(_num_pieces);
+        _symmetries.identical_pieces = _find_identical_pieces(pieces);
+        _symmetries.rotations = _find_puzzle_symmetries(pieces, positions);
+        _initial_positions = positions;
+        _positions = positions;
+        _load_errors.clear();
+
+        return true;
     }
 
-    void init_field() noexcept
+    void init_field() noexcept override
     {
         for (size_t i = 0; i < _num_pieces; i++) {
-            int index = utils::transform_index_3d_to_1d(_initial_positions[i], _dim);
-
-            _field |= _puzzle[i].get_bitset(index);
+            _field.add(_puzzle[i], _initial_positions[i]);
         }
     }
 
-    void init_start_node() noexcept
+    void init_start_node() noexcept override
     {
-        _start = Node(_initial_positions, N);
+        _start = Node(_initial_positions, N, &_symmetries);
     }
 
-    void move_piece(size_t index, utils::int3 direction) noexcept
+    void move_piece(size_t index, utils::int3 direction) noexcept override
     {
+        if (_field_dirty) {
+            _build_field_from_positions(_positions);
+            _field_dirty = false;
+        }
+
         if (_collides(index, direction))
             return;
 
-        _field ^= _puzzle[index].get_bitset(_positions[index]);
+        _field.remove(_puzzle[index], _positions[index]);
         _positions[index] += direction;
-        _field |= _puzzle[index].get_bitset(_positions[index]);
+        _field.add(_puzzle[index], _positions[index]);
     }
     
-    [[nodiscard]] std::vector<std::vector<utils::int3>> get_all_unit_cube_global_positions() const noexcept
+    // Replaces the displayed positions, e.g. with a step of the solution. The field is rebuilt lazily on the next manual move.
+    void set_positions(const std::vector<utils::int3>& positions) noexcept override
     {
-        std::vector<std::vector<utils::int3>> all_unit_cube_coordinates;
-        all_unit_cube_coordinates.resize(_num_pieces);
-
-        for (size_t i = 0; i < _num_pieces; i++) {
+        _positions = positions;
+        _field_dirty = true;
+    }
 
-            auto piece = _puzzle[i];
-            const auto& positions = piece.get_unit_cube_positions();
-            utils::int3 translation = _positions[i];
+    [[nodiscard]] const std::vector<utils::int3>& get_positions() const noexcept override
+    {
+        return _positions;
+    }
 
-            for (size_t j = 0; j < positions.size(); j++) {
-                utils::int3 pos = positions[j] + translation;
-                
-                all_unit_cube_coordinates[i].push_back(pos);
-            }
-        }
+    [[nodiscard]] const std::vector<utils::int3>& get_unit_cube_positions(size_t index) const noexcept override
+    {
+        return _puzzle[index].get_unit_cube_positions();
+    }
 
-        return all_unit_cube_coordinates;
+    [[nodiscard]] const std::vector<PuzzleParseError>& get_load_errors() const noexcept override
+    {
+        return _load_errors;
     }
 
-    [[nodiscard]] const std::vector<utils::int3>& get_initial_positions() const noexcept
+    [[nodiscard]] const std::vector<utils::int3>& get_initial_positions() const noexcept override
     {
         return _initial_positions;
     }
 
-    [[nodiscard]] size_t get_dim() const noexcept
+    [[nodiscard]] size_t get_dim() const noexcept override
     {
         return _dim;
     }
 
-    [[nodiscard]] size_t get_volume() const noexcept
+    [[nodiscard]] size_t get_volume() const noexcept override
     {
         return _volume;
     }
 
-    [[nodiscard]] const glm::vec3& get_color(size_t index) const noexcept
+    [[nodiscard]] const glm::vec3& get_color(size_t index) const noexcept override
     {
         return _colors[index];
     }
 
-    [[nodiscard]] size_t get_num_pieces() const noexcept
+    [[nodiscard]] size_t get_num_pieces() const noexcept override
     {
         return _num_pieces;
     }
 
-    [[nodiscard]] bool is_solved() const noexcept
+    [[nodiscard]] const std::vector<std::vector<size_t>>& get_identical_pieces() const noexcept override
+    {
+        return _symmetries.identical_pieces;
+    }
+
+    // Order of the rotation group that maps the assembled puzzle onto itself, 1 for asymmetric puzzles
+    [[nodiscard]] size_t get_num_symmetries() const noexcept override
+    {
+        return _symmetries.rotations.size() + 1;
+    }
+
+    [[nodiscard]] OccupancyBackend get_backend() const noexcept override
+    {
+        return std::is_same_v<Occupancy, SparseOccupancy> ? OccupancyBackend::Sparse : OccupancyBackend::Dense;
+    }
+
+    [[nodiscard]] bool is_solved() const noexcept override
     {
         return _solved;
     }
 
-    [[nodiscard]] double get_solve_time() const noexcept
+    [[nodiscard]] double get_solve_time() const noexcept override
     {
         return _solution_time;
     }
 
-    [[nodiscard]] int get_nodes_visited() const noexcept
+    [[nodiscard]] int get_nodes_visited() const noexcept override
     {
         return _nodes_visited;
     }
 
-    [[nodiscard]] int get_current_solution_state() const noexcept
+    [[nodiscard]] SolveStatus get_status() const noexcept override
     {
-        return _displayed_solution_step;
+        return _status;
     }
 
-    [[nodiscard]] int get_solution_size() const noexcept
+    [[nodiscard]] size_t get_peak_memory_usage() const noexcept override
     {
-        return static_cast<int>(_solution.size());
+        return _memory_usage.peak_total;
     }
 
-    void set_solution_state(bool next)
+    void set_limits(const SolverLimits& limits) noexcept override
     {
-        if (next) {
-            _displayed_solution_step = std::min({_displayed_solution_step + 1, static_cast<int>(_solution.size()) - 1});
-        } else {
-            _displayed_solution_step = std::max({_displayed_solution_step - 1, 0});
-        }
+        _limits = limits;
+    }
+
+    void set_search_options(const SearchOptions& options) noexcept override
+    {
+        _options = options;
+    }
 
-        _build_field_from_node(_solution[_displayed_solution_step]);
-        _positions = _solution[_displayed_solution_step].get_positions();
+    [[nodiscard]] const SolutionTimeline& get_solution() const noexcept override
+    {
+        return _solution;
+    }
+
+    [[nodiscard]] const std::vector<std::vector<utils::int3>>& get_solution_path() const noexcept override
+    {
+        return _solution_path;
     }
 
-    bool solve() noexcept
+    // Snapshots of the running or last search, safe to call from another thread while solve() runs
+    [[nodiscard]] SearchStatistics get_search_statistics() const override
+    {
+        std::scoped_lock lock(_progress_mutex);
+        return _published_statistics;
+    }
+
+    [[nodiscard]] MemoryUsage get_memory_usage() const override
+    {
+        std::scoped_lock lock(_progress_mutex);
+        return _published_memory_usage;
+    }
+
+    bool solve() noexcept override
     {
         auto start = std::chrono::high_resolution_clock::now();
 
-        std::unordered_set<std::vector<utils::int3>> visited;
-        std::unordered_map<Node, Node> parents;
-        std::priority_queue<Node> queue;
+#ifdef BURR_PUZZLE_WIZARD_PROFILE
+        Profiler::get().reset();
+#endif
+
+        // States never move once stored, so expansions can hold references to them while children are appended
+        std::deque<SearchState> states;
+
+        // Key of every generated state to its index, or to pending_child and the parent for a child that partial
+        // expansion has generated but not stored yet
+        std::unordered_map<std::vector<utils::int3>, uint32_t> visited;
+        OpenList queue;
+        uint64_t next_sequence = 0;
+
+        // Heap bytes owned by the entries, the bucket array is added in update_memory_usage
+        size_t closed_set_bytes = 0;
+        size_t state_arena_bytes = 0;
+        size_t blocking_graphs_bytes = 0;
+
+        auto update_memory_usage = [&] {
+            _memory_usage.open_list = queue.capacity() * sizeof(OpenEntry);
+            _memory_usage.closed_set = visited.bucket_count() * sizeof(void*) + closed_set_bytes;
+            _memory_usage.state_arena = state_arena_bytes;
+            _memory_usage.blocking_graphs = blocking_graphs_bytes;
+            _memory_usage.piece_cache = 0;
+            _memory_usage.stored_states = states.size();
+
+            for (const auto& piece : _puzzle) {
+                _memory_usage.piece_cache += piece.get_cache_memory_usage();
+            }
 
-        visited.insert(_start.get_key());
-        queue.push(_start);
+            _memory_usage.peak_total = std::max(_memory_usage.peak_total, _memory_usage.get_total());
+        };
+
+        auto push = [&](int priority, uint64_t sequence, uint32_t state) {
+            BPW_PROFILE_SCOPE(ProfilePhase::QueueOperations);
+            queue.push({priority, sequence, state});
+            _statistics.record_push(priority);
+        };
+
+        _statistics.clear();
+        _memory_usage = {};
+
+        visited.emplace(_start.get_key(), 0);
+        closed_set_bytes += _get_closed_set_entry_usage(_start);
+        states.push_back({_start});
+        state_arena_bytes += sizeof(SearchState) + _start.get_heap_usage();
+        push(_get_priority(_start.get_positions(), 0), next_sequence++, 0);
+
+        update_memory_usage();
+        _publish_progress();
+
+        auto finish = [&](SolveStatus status) {
+            _status = status;
+            _nodes_visited = static_cast<int>(states.size());
+            update_memory_usage();
+            _publish_progress();
+
+            auto end = std::chrono::high_resolution_clock::now();
+            _solution_time = std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(end - start).count();
+
+            return status == SolveStatus::Solved;
+        };
 
         while (!queue.empty()) {
-            Node current = queue.top();
-            queue.pop();
+            if (_limits.max_time_ms > 0.0) {
+                auto now = std::chrono::high_resolution_clock::now();
+
+                if (std::chrono::duration<double, std::milli>(now - start).count() > _limits.max_time_ms)
+                    return finish(SolveStatus::TimeLimit);
+            }
+
+            // Stops before the next expansion grows the containers past the budget
+            if (_limits.max_memory_bytes > 0 && _memory_usage.get_total() > _limits.max_memory_bytes)
+                return finish(SolveStatus::MemoryLimit);
 
-            _build_field_from_node(current);
+            OpenEntry entry;
 
-            if (_is_end_node(current)) {
-                while (current != _start) {
-                    _solution.push_back(current);
-                    current = parents[current];
+            {
+                BPW_PROFILE_SCOPE(ProfilePhase::QueueOperations);
+                entry = queue.top();
+                queue.pop();
+            }
+
+            _statistics.record_pop(entry.priority);
+
+            SearchState& state = states[entry.state];
+            const Node& current = state.node;
+
+            // Left behind by a state that was reopened with fewer moves and has been expanded since
+            if (state.expanded && entry.sequence < state.first_child_sequence)
+                continue;
+
+            if (!state.expanded && _is_end_node(current)) {
+                std::vector<uint32_t> path;
+
+                for (uint32_t index = entry.state; index != no_parent; index = states[index].parent) {
+                    path.push_back(index);
+                }
+
+                std::ranges::reverse(path);
+
+                _solution_path.clear();
+
+                for (uint32_t index : path) {
+                    _solution_path.push_back(states[index].node.get_positions());
                 }
 
-                _solution.push_back(_start);
-                std::ranges::reverse(_solution);
+                _solution = SolutionTimeline(_start.get_positions());
+
+                for (size_t i = 1; i < _solution_path.size(); i++) {
+                    _solution.push_move(Move::from_positions(_solution_path[i - 1], _solution_path[i]));
+                }
 
                 _solved = true;
-                _nodes_visited = static_cast<int>(visited.size());
+                _field_dirty = true;
 
-                auto end = std::chrono::high_resolution_clock::now();
-                _solution_time = std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(end - start).count();
+                return finish(SolveStatus::Solved);
+            }
 
-                return true;
+            {
+                BPW_PROFILE_SCOPE(ProfilePhase::FieldRebuild);
+                _build_field_from_node(current);
             }
 
-            for (const auto& neighbor : _get_neighbor_nodes(current)) {
-                if (!visited.contains(neighbor.get_key())) {
-                    visited.insert(neighbor.get_key());
-                    parents[neighbor] = current;
-                    queue.push(neighbor);
+            // Children up to `threshold` are stored now. Every expansion generates the children in the same order,
+            // so a child gets the same sequence number whichever expansion stores it. The first expansion claims all
+            // children in the closed set, so partial expansion stores the same states in the same order as full.
+            const bool first_expansion = !state.expanded;
+            const int threshold = _options.expansion == ExpansionMode::Partial ? entry.priority : std::numeric_limits<int>::max();
+            int next_priority = std::numeric_limits<int>::max();
+            uint64_t next_priority_sequence = 0;
+            uint64_t num_children = 0;
+            size_t num_neighbors = 0;
+
+            auto visit = [&](const std::vector<utils::int3>& positions) {
+                const uint64_t sequence = state.first_child_sequence + num_children++;
+                const uint32_t moves = state.moves + 1;
+                const int priority = _get_priority(positions, moves);
+
+                if (priority <= state.stored_priority)
+                    return;
+
+                const bool store = priority <= threshold;
+
+                if (!store && priority < next_priority) {
+                    next_priority = priority;
+                    next_priority_sequence = sequence;
+                }
+
+                if (!store && !first_expansion)
+                    return;
+
+                Node neighbor;
+
+                {
+                    BPW_PROFILE_SCOPE(ProfilePhase::NodeConstruction);
+                    neighbor = Node(positions, _dim, &_symmetries);
+                }
+
+                const uint32_t index = static_cast<uint32_t>(states.size());
+
+                if (first_expansion) {
+                    typename decltype(visited)::iterator claim;
+                    bool inserted;
+
+                    {
+                        BPW_PROFILE_SCOPE(ProfilePhase::Hashing);
+                        std::tie(claim, inserted) = visited.try_emplace(neighbor.get_key(), store ? index : pending_child | entry.state);
+                    }
+
+                    num_neighbors++;
+                    _statistics.record_generated(!inserted);
+
+                    if (inserted) {
+                        closed_set_bytes += _get_closed_set_entry_usage(neighbor);
+
+                        if (!store)
+                            return;
+                    } else {
+                        // Greedy search keeps the first path to a state. A* and breadth-first keep the shortest one
+                        // until the state is expanded; with a consistent heuristic an expanded state has no shorter path.
+                        if (_options.mode == SearchMode::Greedy)
+                            return;
+
+                        if (!(claim->second & pending_child)) {
+                            SearchState& child = states[claim->second];
+
+                            if (child.expanded || child.moves <= moves)
+                                return;
+
+                            // The positions of the new path, they may be a translated or symmetric image of the old ones
+                            state_arena_bytes += neighbor.get_heap_usage() - child.node.get_heap_usage();
+                            child = {std::move(neighbor), entry.state, moves};
+                            push(priority, sequence, claim->second);
+                            _statistics.record_reopen();
+
+                            return;
+                        }
+
+                        if (states[claim->second & ~pending_child].moves + 1 <= moves)
+                            return;
+
+                        _statistics.record_reopen();
+
+                        if (!store) {
+                            claim->second = pending_child | entry.state;
+                            return;
+                        }
+
+                        claim->second = index;
+                    }
+                } else {
+                    BPW_PROFILE_SCOPE(ProfilePhase::Hashing);
+                    auto claim = visited.find(neighbor.get_key());
+
+                    // Another state got to the child first
+                    if (claim == visited.end() || claim->second != (pending_child | entry.state))
+                        return;
+
+                    claim->second = index;
                 }
+
+                state_arena_bytes += sizeof(SearchState) + neighbor.get_heap_usage();
+
+                states.push_back({std::move(neighbor), entry.state, moves});
+                push(priority, sequence, index);
+            };
+
+            if (first_expansion) {
+                const SearchState* parent = state.parent != no_parent ? &states[state.parent] : nullptr;
+
+                state.first_child_sequence = next_sequence;
+                _expand(current, state.graphs, parent ? &parent->node : nullptr, parent ? &parent->graphs : nullptr, visit);
+                state.expanded = true;
+
+                next_sequence += num_children;
+                blocking_graphs_bytes += state.graphs.get_heap_usage();
+            } else {
+                _statistics.record_reexpansion();
+                _visit_neighbors(current, state.graphs, visit);
+            }
+
+            state.stored_priority = threshold;
+
+            if (next_priority != std::numeric_limits<int>::max())
+                push(next_priority, next_priority_sequence, entry.state);
+
+            update_memory_usage();
+
+            if (first_expansion) {
+                _statistics.record_expansion(num_neighbors, queue.size());
+
+                if (_statistics.get_expansions() % progress_publish_interval == 0)
+                    _publish_progress();
             }
         }
 
-        return false;
+        return finish(SolveStatus::Unsolvable);
     }
 
 private:
+    static constexpr uint64_t progress_publish_interval = 1024;
+    static constexpr uint32_t no_parent = std::numeric_limits<uint32_t>::max();
+    static constexpr uint32_t pending_child = uint32_t(1) << 31;
+
+    // The grid size as a bound of signed coordinates
+    static constexpr int _int_dim = static_cast<int>(N);
+
+    // Blocking graphs are derived from the parent's while the moved group is at most 1 / share of the interlocked pieces
+    static constexpr size_t max_incremental_group_share = 2;
+
+    // A stored state of the search, the open list and the parent links refer to states by index
+    struct SearchState
+    {
+        Node node;
+        uint32_t parent = no_parent;
+
+        // Length of the path from the start through the parent links
+        uint32_t moves = 0;
+        bool expanded = false;
+
+        // Children up to this priority are stored, partial expansion stores the rest in later expansions
+        int stored_priority = std::numeric_limits<int>::min();
+        uint64_t first_child_sequence = 0;
+
+        // Filled by the first expansion, the children derive their own graphs from these
+        BlockingGraphs graphs = {};
+    };
+
+    struct OpenEntry
+    {
+        int priority;
+        uint64_t sequence;
+        uint32_t state;
+
+        // Reversed as we want the lowest value at the top of the priority queue, equal priorities in generation order
+        [[nodiscard]] bool operator<(const OpenEntry& other) const noexcept
+        {
+            return std::tie(priority, sequence) > std::tie(other.priority, other.sequence);
+        }
+    };
+
+    // Exposes the capacity of the underlying vector for memory accounting
+    class OpenList final : public std::priority_queue<OpenEntry>
+    {
+    public:
+        [[nodiscard]] size_t capacity() const noexcept
+        {
+            return this->c.capacity();
+        }
+    };
+
+    // Open list priority of a state with these positions reached in `moves` moves, the lowest comes first
+    [[nodiscard]] int _get_priority(const std::vector<utils::int3>& positions, uint32_t moves) const noexcept
+    {
+        switch (_options.mode) {
+            case SearchMode::Greedy: return Node::calculate_priority(positions, _int_dim);
+            case SearchMode::AStar: return static_cast<int>(moves) + _get_min_moves_left(_num_pieces - Node::count_free_pieces(positions, _int_dim));
+            case SearchMode::BreadthFirst: return static_cast<int>(moves);
+        }
+
+        return 0;
+    }
+
+    // Lower bound on the moves until at most two pieces are interlocked. Every neighbor moves a single component of at
+    // most half of the interlocked pieces, and whether a piece is free depends on its own position only, so a move
+    // from k interlocked pieces leaves at least k - k / 2. The bound grows with k and one move lowers it by at most
+    // one, so it never overestimates and stays consistent.
+    [[nodiscard]] static int _get_min_moves_left(size_t num_interlocked) noexcept
+    {
+        int moves = 0;
+
+        for (; num_interlocked > 2; moves++) {
+            num_interlocked -= num_interlocked / 2;
+        }
+
+        return moves;
+    }
+
+    [[nodiscard]] static size_t _get_closed_set_entry_usage(const Node& node) noexcept
+    {
+        return sizeof(void*) + sizeof(size_t) + sizeof(std::pair<const std::vector<utils::int3>, uint32_t>) + node.get_key().size() * sizeof(utils::int3) + 2 * utils::allocation_overhead;
+    }
+
+    void _publish_progress() noexcept
+    {
+        std::scoped_lock lock(_progress_mutex);
+        _published_statistics = _statistics;
+        _published_memory_usage = _memory_usage;
+    }
+
+    bool _read_binary_puzzle(const std::filesystem::path& path) noexcept
+    {
+        BinaryPuzzle binary;
+
+        if (!binary.open(path)) {
+            _load_errors = {{0, binary.get_error()}};
+            return false;
+        }
+
+        std::vector<std::vector<utils::int3>> pieces;
+        std::vector<utils::int3> positions;
+
+        for (size_t i = 0; i < binary.get_num_pieces(); i++) {
+            pieces.push_back(binary.get_unit_cube_positions(i));
+            positions.push_back(binary.get_position(i));
+        }
+
+        return load_puzzle(pieces, positions);
+    }
+
+    void _build_field_from_positions(const std::vector<utils::int3>& positions) noexcept
+    {
+        _field.clear();
+
+        for (size_t i = 0; i < _num_pieces; i++) {
+            _field.add(_puzzle[i], positions[i]);
+        }
+    }
+
     void _build_field_from_node(const Node& node) noexcept
     {
-        _field.reset();
+        _field.clear();
         const auto& positions = node.get_positions();
         const auto& free_pieces = node.get_free_pieces();
         
         for (size_t i = 0; i < _num_pieces; i++) {
             if (free_pieces[i])
                 continue;
-            
-            int index = utils::transform_index_3d_to_1d(positions[i], _dim);
 
-            _field |= _puzzle[i].get_bitset(index);
+
+            _field.add(_puzzle[i], positions[i]);
         }
     }
 
-    [[nodiscard]] std::vector<Node> _get_neighbor_nodes(const Node& node) const noexcept
+    // Size of the box from the piece origin to its farthest unit cube
+    [[nodiscard]] static utils::int3 _get_extent(const std::vector<utils::int3>& unit_cubes) noexcept
+    {
+        utils::int3 extent = {0, 0, 0};
+
+        for (const auto& cube : unit_cubes) {
+            extent = {std::max(extent.x, cube.x + 1), std::max(extent.y, cube.y + 1), std::max(extent.z, cube.z + 1)};
+        }
+
+        return extent;
+    }
+
+    // Groups of pieces with exactly the same unit cubes, pieces that only match after a rotation are not
+    // interchangeable because positions are translations
+    [[nodiscard]] static std::vector<std::vector<size_t>> _find_identical_pieces(const std::vector<std::vector<utils::int3>>& pieces) noexcept
+    {
+        std::vector<std::vector<utils::int3>> shapes;
+
+        for (const auto& unit_cubes : pieces) {
+            shapes.push_back(unit_cubes);
+            std::ranges::sort(shapes.back(), {}, [](const utils::int3& v) { return std::tuple(v.x, v.y, v.z); });
+        }
+
+        std::vector<std::vector<size_t>> groups;
+        std::vector<bool> grouped(pieces.size(), false);
+
+        for (size_t i = 0; i < pieces.size(); i++) {
+            if (grouped[i])
+                continue;
+
+            std::vector<size_t> group = {i};
+
+            for (size_t j = i + 1; j < pieces.size(); j++) {
+                if (!grouped[j] && shapes[j] == shapes[i]) {
+                    group.push_back(j);
+                    grouped[j] = true;
+                }
+            }
+
+            if (group.size() > 1)
+                groups.push_back(std::move(group));
+        }
+
+        return groups;
+    }
+
+    // Rotations that turn every piece into a piece of the same shape at the place of that piece in the start
+    // position, up to a translation of the whole puzzle
+    [[nodiscard]] static std::vector<PuzzleSymmetry> _find_puzzle_symmetries(const std::vector<std::vector<utils::int3>>& pieces, const std::vector<utils::int3>& positions) noexcept
+    {
+        std::vector<PuzzleSymmetry> symmetries;
+
+        if (pieces.empty() || std::ranges::any_of(pieces, &std::vector<utils::int3>::empty))
+            return symmetries;
+
+        std::vector<std::vector<utils::int3>> shapes;
+        std::vector<utils::int3> mins;
+
+        for (const auto& unit_cubes : pieces) {
+            shapes.push_back(orientation::normalize(unit_cubes));
+            mins.push_back(orientation::get_min(unit_cubes));
+        }
+
+        const auto& rotations = orientation::get_rotations();
+
+        for (size_t r = 1; r < rotations.size(); r++) {
+            std::vector<std::vector<utils::int3>> rotated_shapes;
+            std::vector<utils::int3> rotated_mins;
+
+            for (const auto& unit_cubes : pieces) {
+                std::vector<utils::int3> rotated;
+
+                for (const auto& cube : unit_cubes) {
+                    rotated.push_back(orientation::rotate(rotations[r], cube));
+                }
+
+                rotated_mins.push_back(orientation::get_min(rotated));
+                rotated_shapes.push_back(orientation::normalize(std::move(rotated)));
+            }
+
+            // Rotated piece i covers the cubes of piece j at the returned position
+            auto get_landing = [&](size_t i, size_t j) {
+                const utils::int3 offset = {rotated_mins[i].x - mins[j].x, rotated_mins[i].y - mins[j].y, rotated_mins[i].z - mins[j].z};
+                return orientation::rotate(rotations[r], positions[i]) + offset;
+            };
+
+            auto get_translation = [&](size_t i, size_t j) {
+                const utils::int3 landing = get_landing(i, j);
+                return utils::int3{landing.x - positions[j].x, landing.y - positions[j].y, landing.z - positions[j].z};
+            };
+
+            PuzzleSymmetry symmetry = {rotations[r], {}, {}};
+
+            // The translation is fixed by where piece 0 lands, identical pieces are then told apart by it
+            for (size_t first = 0; first < pieces.size() && symmetry.permutation.empty(); first++) {
+                if (shapes[first] != rotated_shapes[0])
+                    continue;
+
+                const utils::int3 translation = get_translation(0, first);
+                std::vector<size_t> permutation;
+                std::vector<bool> used(pieces.size(), false);
+
+                for (size_t i = 0; i < pieces.size(); i++) {
+                    for (size_t j = 0; j < pieces.size(); j++) {
+                        if (!used[j] && shapes[j] == rotated_shapes[i] && get_translation(i, j) == translation) {
+                            permutation.push_back(j);
+                            used[j] = true;
+                            break;
+                        }
+                    }
+
+                    if (permutation.size() != i + 1)
+                        break;
+                }
+
+                if (permutation.size() == pieces.size())
+                    symmetry.permutation = std::move(permutation);
+            }
+
+            if (symmetry.permutation.empty())
+                continue;
+
+            for (size_t i = 0; i < pieces.size(); i++) {
+                const size_t j = symmetry.permutation[i];
+                symmetry.offsets.push_back({rotated_mins[i].x - mins[j].x, rotated_mins[i].y - mins[j].y, rotated_mins[i].z - mins[j].z});
+            }
+
+            symmetries.push_back(std::move(symmetry));
+        }
+
+        return symmetries;
+    }
+
+    // Calls `visitor` with the positions of every neighbor of the node. The positions are a scratch buffer that the
+    // next neighbor overwrites, so once the buffers have grown to the puzzle an expansion does not allocate.
+    template <typename Visitor>
+    void _expand(const Node& node, BlockingGraphs& graphs, const Node* parent, const BlockingGraphs* parent_graphs, Visitor&& visitor) const
+    {
+        {
+            BPW_PROFILE_SCOPE(ProfilePhase::BlockingGraph);
+
+            _scratch.contacts.build(node.get_positions(), _extents, node.get_free_pieces());
+
+            if (parent && parent_graphs)
+                _update_blocking_graphs(node, *parent, *parent_graphs, _scratch.contacts, graphs);
+            else
+                _build_blocking_graphs(node, _scratch.contacts, graphs);
+        }
+
+        _visit_neighbors(node, graphs, visitor);
+    }
+
+    // Generates the neighbors from blocking graphs that are already built, e.g. when a state is expanded again
+    template <typename Visitor>
+    void _visit_neighbors(const Node& node, const BlockingGraphs& graphs, Visitor&& visitor) const
+    {
+        const size_t max_component_size = (_num_pieces - static_cast<size_t>(std::ranges::count(node.get_free_pieces(), true))) / 2;
+
+        for (size_t direction = 0; direction < BlockingGraphs::directions.size(); direction++) {
+            _add_neighbor_nodes(direction, max_component_size, node, graphs, visitor);
+        }
+    }
+
+    void _build_blocking_graphs(const Node& node, const ContactIndex& contacts, BlockingGraphs& graphs) const noexcept
     {
-        std::vector<Node> neighbors;
-        
         const auto& free_pieces = node.get_free_pieces();
-        const auto& piece_positions = node.get_positions();
-        
-        size_t max_component_size = (_num_pieces - static_cast<size_t>(std::ranges::count(free_pieces, true))) / 2;
-
-        _add_neighbor_nodes(neighbors, piece_positions, {-1, 0 , 0}, max_component_size, node);
-        _add_neighbor_nodes(neighbors, piece_positions, {1, 0 , 0}, max_component_size, node);
-        _add_neighbor_nodes(neighbors, piece_positions, {0, -1 , 0}, max_component_size, node);
-        _add_neighbor_nodes(neighbors, piece_positions, {0, 1 , 0}, max_component_size, node);
-        _add_neighbor_nodes(neighbors, piece_positions, {0, 0 , -1}, max_component_size, node);
-        _add_neighbor_nodes(neighbors, piece_positions, {0, 0 , 1}, max_component_size, node);
-        
-        return neighbors;
+
+        graphs.reset(_num_pieces);
+
+        for (size_t piece = 0; piece < _num_pieces; piece++) {
+            if (free_pieces[piece])
+                continue;
+
+            for (size_t direction = 0; direction < BlockingGraphs::directions.size(); direction++) {
+                graphs.set_blockers(direction, piece, _get_collisions(piece, BlockingGraphs::directions[direction], node, contacts));
+            }
+        }
+    }
+
+    // A child differs from its parent only in the pieces of the moved group, so only the edges from and to those
+    // pieces are recomputed. Edges of pieces that became free are dropped. Falls back to a full build when the group
+    // is a large part of the interlocked pieces.
+    void _update_blocking_graphs(const Node& node, const Node& parent, const BlockingGraphs& parent_graphs, const ContactIndex& contacts, BlockingGraphs& graphs) const noexcept
+    {
+        const auto& free_pieces = node.get_free_pieces();
+        const auto& positions = node.get_positions();
+        const auto& parent_positions = parent.get_positions();
+
+        uint64_t moved = 0;
+        uint64_t freed = 0;
+        size_t num_interlocked = 0;
+
+        for (size_t piece = 0; piece < _num_pieces; piece++) {
+            if (!free_pieces[piece])
+                num_interlocked++;
+
+            if (positions[piece] == parent_positions[piece])
+                continue;
+
+            moved |= uint64_t(1) << piece;
+
+            if (free_pieces[piece])
+                freed |= uint64_t(1) << piece;
+        }
+
+        if (static_cast<size_t>(std::popcount(moved & ~freed)) * max_incremental_group_share > num_interlocked) {
+            _build_blocking_graphs(node, contacts, graphs);
+            return;
+        }
+
+        graphs = parent_graphs;
+        graphs.remove_pieces(moved);
+
+        for (uint64_t rest = moved & ~freed; rest != 0; rest &= rest - 1) {
+            const size_t piece = static_cast<size_t>(std::countr_zero(rest));
+
+            for (size_t direction = 0; direction < BlockingGraphs::directions.size(); direction++) {
+                const utils::int3 step = BlockingGraphs::directions[direction];
+                const size_t opposite = BlockingGraphs::get_opposite(direction);
+                uint64_t hits = 0;
+
+                for (uint32_t other : contacts.get_contacts(piece)) {
+                    if (_puzzle[piece].overlaps(positions[piece] + step, _puzzle[other], positions[other]))
+                        hits |= uint64_t(1) << other;
+                }
+
+                graphs.set_blockers(direction, piece, _is_inside(positions[piece] + step) ? hits : 0);
+
+                // The piece moving by `step` hits `other` exactly when `other` moving the opposite way hits the piece.
+                // Pairs within the group are covered by the rows of both pieces.
+                for (uint64_t others = hits & ~moved; others != 0; others &= others - 1) {
+                    const size_t other = static_cast<size_t>(std::countr_zero(others));
+
+                    if (_is_inside(positions[other] + BlockingGraphs::directions[opposite]))
+                        graphs.set_blocker(opposite, other, piece);
+                }
+            }
+        }
     }
 
-    void _add_neighbor_nodes(std::vector<Node>& neighbors, const std::vector<utils::int3>& piece_positions, utils::int3 direction, const size_t max_component_size, const Node& node) const
+    template <typename Visitor>
+    void _add_neighbor_nodes(size_t direction_index, const size_t max_component_size, const Node& node, const BlockingGraphs& graphs, Visitor& visitor) const
     {
-        std::vector<bool> free_pieces = node.get_free_pieces();
-        std::vector<utils::int3> new_positions = piece_positions;
-        std::unordered_map<int, std::vector<int>> graph;
+        const utils::int3 direction = BlockingGraphs::directions[direction_index];
+        const auto& piece_positions = node.get_positions();
+        const auto& free_pieces = node.get_free_pieces();
+        auto& new_positions = _scratch.new_positions;
+        auto& components = _scratch.components;
 
         int dim = -1;
         int sign = 0;
@@ -322,45 +957,65 @@ private:
             throw std::runtime_error("Incompatible direction vector.");
         
         new_positions = piece_positions;
-        
+
+        uint64_t pieces = 0;
+
         for (size_t i = 0; i < _num_pieces; i++) {
-            if (!free_pieces[i]) {
-                graph[i] = _get_collisions(i, direction, node);
-            }
+            if (!free_pieces[i])
+                pieces |= uint64_t(1) << i;
+        }
+
+        {
+            BPW_PROFILE_SCOPE(ProfilePhase::StronglyConnectedComponents);
+            _find_strongly_connected_components(graphs, direction_index, pieces, components);
         }
 
-        std::vector<std::vector<int>> strongly_connected_components = _find_strongly_connected_components(graph);
+        for (uint64_t component : components) {
+            const size_t component_size = static_cast<size_t>(std::popcount(component));
 
-        for (auto& component : strongly_connected_components) {
-            if (component.size() <= max_component_size) {
+            _statistics.record_component(component_size);
+
+            if (component_size <= max_component_size) {
 
                 int max = 0;
-                
-                for (int unit = 0; unit < _dim; unit++) {
-                    if (!_collides(component, piece_positions, direction * unit))
-                        max = unit;
-                    else
-                        break;
+
+                {
+                    BPW_PROFILE_SCOPE(ProfilePhase::SlideDistance);
+
+                    for (int unit = 0; unit < _int_dim; unit++) {
+                        if (!_collides(component, piece_positions, direction * unit))
+                            max = unit;
+                        else
+                            break;
+                    }
                 }
 
+                _statistics.record_slide(max);
+
                 if (max != 0) {
                     bool is_piece_in_component_free = false;
 
-                    for (int piece : component) {
-                        if (new_positions[piece][dim] + sign * max == (sign == -1 ? 0 : _dim - 1)) {
-                            free_pieces[piece] = true;
+                    for (uint64_t rest = component; rest != 0; rest &= rest - 1) {
+                        if (piece_positions[std::countr_zero(rest)][dim] + sign * max == (sign == -1 ? 0 : _int_dim - 1))
                             is_piece_in_component_free = true;
-                        }
                     }
 
-                    for (int piece : component) {
+                    for (uint64_t rest = component; rest != 0; rest &= rest - 1) {
+                        const int piece = std::countr_zero(rest);
+
                         if (is_piece_in_component_free)
                             new_positions[piece][dim] += sign * max;
                         else
                             new_positions[piece][dim] += sign;
                     }
 
-                    neighbors.emplace_back(new_positions, _dim);
+                    visitor(std::as_const(new_positions));
+
+                    // Every neighbor moves a single component
+                    for (uint64_t rest = component; rest != 0; rest &= rest - 1) {
+                        const int piece = std::countr_zero(rest);
+                        new_positions[piece] = piece_positions[piece];
+                    }
                 }
             }
         }
@@ -370,156 +1025,158 @@ private:
     {
         utils::int3 new_position_3d = _positions[piece] + direction;
 
-        if (new_position_3d.x < 0 || new_position_3d.x > _dim) return true;
-        if (new_position_3d.y < 0 || new_position_3d.y > _dim) return true;
-        if (new_position_3d.z < 0 || new_position_3d.z > _dim) return true;
-
-        int new_position_1d = utils::transform_index_3d_to_1d(new_position_3d, _dim);
-
-        std::bitset<N*N*N> temp(_field);
-        temp ^= _puzzle[piece].get_bitset(_positions[piece]);
+        if (new_position_3d.x < 0 || new_position_3d.x > _int_dim) return true;
+        if (new_position_3d.y < 0 || new_position_3d.y > _int_dim) return true;
+        if (new_position_3d.z < 0 || new_position_3d.z > _int_dim) return true;
 
-        if ((temp & _puzzle[piece].get_bitset(new_position_1d)).any()) {
-            return true;
-        }
+        _field.remove(_puzzle[piece], _positions[piece]);
+        const bool collides = _field.overlaps(_puzzle[piece], new_position_3d);
+        _field.add(_puzzle[piece], _positions[piece]);
 
-        return false;
-        
+        return collides;
     }
     
-    [[nodiscard]] bool _collides(std::vector<int> pieces, const std::vector<utils::int3>& piece_positions, utils::int3 direction) const noexcept
+    // Whether the pieces of the mask, moved together by `direction`, hit the rest of the field or leave the grid
+    [[nodiscard]] bool _collides(uint64_t pieces, const std::vector<utils::int3>& piece_positions, utils::int3 direction) const noexcept
     {
-        std::vector<int> new_positions;
-
-        for (int piece : pieces) {
-            utils::int3 position = piece_positions[piece];
-            position += direction;
+        for (uint64_t rest = pieces; rest != 0; rest &= rest - 1) {
+            const utils::int3 position = piece_positions[std::countr_zero(rest)] + direction;
 
-            if (position.x >= _dim || position.y >= _dim || position.z >= _dim)
+            if (position.x >= _int_dim || position.y >= _int_dim || position.z >= _int_dim)
                 return true;
             
             if (position.x < 0 || position.y < 0 || position.z < 0)
                 return true;
+        }
 
-            int new_index = utils::transform_index_3d_to_1d(position, _dim);
-            new_positions.push_back(new_index);
+        for (uint64_t rest = pieces; rest != 0; rest &= rest - 1) {
+            const int piece = std::countr_zero(rest);
+            _field.remove(_puzzle[piece], piece_positions[piece]);
         }
 
-        std::bitset<N*N*N> temp(_field);
+        // The pieces move together and did not overlap before, so they can only hit the rest of the field
+        bool collides = false;
 
-        for (int piece : pieces) {
-            int index = utils::transform_index_3d_to_1d(piece_positions[piece], _dim);
-            temp ^= _puzzle[piece].get_bitset(index);
+        for (uint64_t rest = pieces; rest != 0 && !collides; rest &= rest - 1) {
+            const int piece = std::countr_zero(rest);
+            collides = _field.overlaps(_puzzle[piece], piece_positions[piece] + direction);
         }
 
-        for (size_t piece = 0; piece < pieces.size(); piece++) {
-            if ((temp & _puzzle[pieces[piece]].get_bitset(new_positions[piece])).any())
-                return true;
-
-            temp |= _puzzle[pieces[piece]].get_bitset(new_positions[piece]);
+        for (uint64_t rest = pieces; rest != 0; rest &= rest - 1) {
+            const int piece = std::countr_zero(rest);
+            _field.add(_puzzle[piece], piece_positions[piece]);
         }
 
-        return false;
+        return collides;
     }
     
-    [[nodiscard]] std::vector<int> _get_collisions(size_t piece, const utils::int3 direction, const Node& node) const noexcept
+    // Pieces hit by `piece` moving one unit in `direction`, as a bit mask. Only pieces in contact with it are
+    // tested, free pieces are not in the contact index.
+    [[nodiscard]] uint64_t _get_collisions(size_t piece, const utils::int3 direction, const Node& node, const ContactIndex& contacts) const noexcept
     {
-        std::vector<int> collisions;
+        uint64_t collisions = 0;
 
-        const auto& free_pieces = node.get_free_pieces();
         const auto& positions = node.get_positions();
-        const auto new_position = positions[piece] + direction;
 
-        if (new_position.x >= _dim || new_position.y >= _dim || new_position.z >= _dim) {
-            return {};
+        for (uint32_t i : contacts.get_contacts(piece)) {
+            if (_blocks(piece, direction, i, positions))
+                collisions |= uint64_t(1) << i;
         }
 
-        if (new_position.x < 0 || new_position.y < 0 || new_position.z < 0) {
-            return {};
-        }
+        return collisions;
+    }
 
-        int new_position_1d = utils::transform_index_3d_to_1d(new_position, _dim);
-        
-        for (size_t i = 0; i < _num_pieces; i++) {
-            if (piece != i && !free_pieces[i]) {
-                int old_position_1d = utils::transform_index_3d_to_1d(positions[i], _dim);
-                
-                if ((_puzzle[piece].get_bitset(new_position_1d) & _puzzle[i].get_bitset(old_position_1d)).any()) {
-                    collisions.push_back(i);
-                }
-            }
-        }
+    // Whether `piece` moving one unit in `direction` hits `other`, a move out of the grid hits nothing
+    [[nodiscard]] bool _blocks(size_t piece, const utils::int3 direction, size_t other, const std::vector<utils::int3>& positions) const noexcept
+    {
+        const auto new_position = positions[piece] + direction;
 
-        return collisions;
+        if (!_is_inside(new_position))
+            return false;
+
+        return _puzzle[piece].overlaps(new_position, _puzzle[other], positions[other]);
     }
 
-    [[nodiscard]] std::vector<std::vector<int>> _find_strongly_connected_components(const std::unordered_map<int, std::vector<int>>& graph) const noexcept
+    [[nodiscard]] bool _is_inside(utils::int3 position) const noexcept
     {
-        std::vector<bool> visited(_num_pieces, false);
-        std::stack<int> stack;
+        return position.x >= 0 && position.y >= 0 && position.z >= 0 && position.x < _int_dim && position.y < _int_dim && position.z < _int_dim;
+    }
 
-        // Perform depth-first search and fill the stack with nodes in the order of their finish times
-        for (const auto& key : graph | std::views::keys) {
-            if (!visited[key]) {
-                _depth_first_search_util(graph, key, visited, stack);
-            }
+    // Kosaraju's algorithm on the blocker masks of `pieces` in one direction, every component is a mask of pieces.
+    // Roots are taken in descending piece order, the order the components came out in before they were masks,
+    // which decides the push order of equal priority neighbors.
+    void _find_strongly_connected_components(const BlockingGraphs& graphs, size_t direction, uint64_t pieces, std::vector<uint64_t>& components) const noexcept
+    {
+        std::array<uint64_t, BlockingGraphs::max_pieces> edges = {};
+        std::array<uint8_t, BlockingGraphs::max_pieces> finished;
+        size_t num_finished = 0;
+        uint64_t visited = 0;
+
+        for (uint64_t rest = pieces; rest != 0; rest &= rest - 1) {
+            const int piece = std::countr_zero(rest);
+            edges[piece] = graphs.get_blockers(direction, piece);
+        }
+
+        // Perform depth-first search and record the nodes in the order of their finish times
+        for (uint64_t rest = pieces; rest != 0;) {
+            const int piece = std::bit_width(rest) - 1;
+            rest &= ~(uint64_t(1) << piece);
+
+            if (!(visited >> piece & 1))
+                _depth_first_search_util(edges, piece, visited, finished, num_finished);
         }
 
         // Reverse the edges of the graph
-        std::unordered_map<int, std::vector<int>> reversed_graph;
+        std::array<uint64_t, BlockingGraphs::max_pieces> reversed_edges = {};
 
-        for (const auto& entry : graph) {
-            int node = entry.first;
-            reversed_graph[node];
+        for (uint64_t rest = pieces; rest != 0; rest &= rest - 1) {
+            const int piece = std::countr_zero(rest);
 
-            for (int neighbor : entry.second) {
-                reversed_graph[neighbor].push_back(node);
+            for (uint64_t blockers = edges[piece]; blockers != 0; blockers &= blockers - 1) {
+                reversed_edges[std::countr_zero(blockers)] |= uint64_t(1) << piece;
             }
         }
 
-        // Reset visited array
-        visited.assign(_num_pieces, false);
+        // Perform depth-first search on the reversed graph in reverse finish order
+        visited = 0;
+        components.clear();
 
-        // Perform depth-first search on the reversed graph using nodes from the stack
-        std::vector<std::vector<int>> strongly_connected_components;
+        while (num_finished > 0) {
+            const int node = finished[--num_finished];
 
-        while (!stack.empty()) {
-            int node = stack.top();
-            stack.pop();
-
-            if (!visited[node]) {
-                std::vector<int> component;
-                _depth_first_search(reversed_graph, node, visited, component);
-                strongly_connected_components.push_back(component);
+            if (!(visited >> node & 1)) {
+                uint64_t component = 0;
+                _depth_first_search(reversed_edges, node, visited, component);
+                components.push_back(component);
             }
         }
-
-        return strongly_connected_components;
     }
 
-    void _depth_first_search(const std::unordered_map<int, std::vector<int>>& graph, int node, std::vector<bool>& visited, std::vector<int>& component) const noexcept
+    void _depth_first_search(const std::array<uint64_t, BlockingGraphs::max_pieces>& edges, int node, uint64_t& visited, uint64_t& component) const noexcept
     {
-        visited[node] = true;
-        component.push_back(node);
+        visited |= uint64_t(1) << node;
+        component |= uint64_t(1) << node;
 
-        for (int neighbor : graph.at(node)) {
-            if (!visited[neighbor]) {
-                _depth_first_search(graph, neighbor, visited, component);
-            }
+        for (uint64_t neighbors = edges[node]; neighbors != 0; neighbors &= neighbors - 1) {
+            const int neighbor = std::countr_zero(neighbors);
+
+            if (!(visited >> neighbor & 1))
+                _depth_first_search(edges, neighbor, visited, component);
         }
     }
 
-    void _depth_first_search_util(const std::unordered_map<int, std::vector<int>>& graph, int node, std::vector<bool>& visited, std::stack<int>& stack) const noexcept
+    void _depth_first_search_util(const std::array<uint64_t, BlockingGraphs::max_pieces>& edges, int node, uint64_t& visited, std::array<uint8_t, BlockingGraphs::max_pieces>& finished, size_t& num_finished) const noexcept
     {
-        visited[node] = true;
+        visited |= uint64_t(1) << node;
 
-        for (int neighbor : graph.at(node)) {
-            if (!visited[neighbor]) {
-                _depth_first_search_util(graph, neighbor, visited, stack);
-            }
+        for (uint64_t neighbors = edges[node]; neighbors != 0; neighbors &= neighbors - 1) {
+            const int neighbor = std::countr_zero(neighbors);
+
+            if (!(visited >> neighbor & 1))
+                _depth_first_search_util(edges, neighbor, visited, finished, num_finished);
         }
 
-        stack.push(node);
+        finished[num_finished++] = static_cast<uint8_t>(node);
     }
     
     [[nodiscard]] bool _is_end_node(const Node& node) const noexcept
@@ -534,14 +1191,29 @@ private:
     size_t _dim = N;
     size_t _volume = N*N*N;
     size_t _num_pieces = 0;
+    StateSymmetries _symmetries;
 
     Node _start;
-    std::bitset<N*N*N> _field;
+    // Mutable because collision tests take the moving pieces out of the field and put them back
+    mutable typename Occupancy::Field _field;
     std::vector<utils::int3> _initial_positions;
     std::vector<utils::int3> _positions;
+    std::vector<PuzzleParseError> _load_errors;
     
-    // Needs to be mutable because Piece<N>::get_bitset modifies this field
-    mutable std::vector<Piece<N>> _puzzle;
+    std::vector<typename Occupancy::Piece> _puzzle;
+
+    // Bounding box size of every piece for the contact index
+    std::vector<utils::int3> _extents;
+
+    // Buffers of an expansion, reserved for the puzzle in load_puzzle and reused by every expansion
+    struct ExpansionScratch
+    {
+        ContactIndex contacts;
+        std::vector<utils::int3> new_positions;
+        std::vector<uint64_t> components;
+    };
+
+    mutable ExpansionScratch _scratch;
 
     std::vector<glm::vec3> _colors = {
         {1.0f, 0.0f, 1.0f},
@@ -564,9 +1236,21 @@ private:
         {0.0f, 0.0f, 1.0f}
     };
 
+    SolverLimits _limits;
+    SearchOptions _options;
+    SolveStatus _status = SolveStatus::NotStarted;
+
     bool _solved = false;
     double _solution_time = 0.0;
     int _nodes_visited = 0;
-    int _displayed_solution_step = 0;
-    std::vector<Node> _solution;
+    bool _field_dirty = false;
+    SolutionTimeline _solution;
+    std::vector<std::vector<utils::int3>> _solution_path;
+
+    // Written from the const expansion helpers, readers only ever see the published copies
+    mutable SearchStatistics _statistics;
+    SearchStatistics _published_statistics;
+    MemoryUsage _memory_usage;
+    MemoryUsage _published_memory_usage;
+    mutable std::mutex _progress_mutex;
 };
@@ -0,0 +1,68 @@
+#include "contact_index.h"
+
+#include <algorithm>
+
+void ContactIndex::build(const std::vector<utils::int3>& positions, const std::vector<utils::int3>& extents, const std::vector<bool>& excluded) noexcept
+{
+    const size_t num_pieces = positions.size();
+
+    _order.clear();
+    _pairs.clear();
+
+    for (size_t i = 0; i < num_pieces; i++) {
+        if (!excluded[i])
+            _order.push_back(static_cast<uint32_t>(i));
+    }
+
+    std::ranges::sort(_order, {}, [&](uint32_t piece) { return positions[piece].x; });
+
+    // Boxes are half-open, grown by one voxel on every side they touch or overlap
+    auto in_contact = [&](uint32_t a, uint32_t b, size_t axis) {
+        return positions[a][axis] <= positions[b][axis] + extents[b][axis] && positions[b][axis] <= positions[a][axis] + extents[a][axis];
+    };
+
+    for (size_t i = 0; i < _order.size(); i++) {
+        const uint32_t a = _order[i];
+
+        for (size_t j = i + 1; j < _order.size() && positions[_order[j]].x <= positions[a].x + extents[a].x; j++) {
+            const uint32_t b = _order[j];
+
+            if (in_contact(a, b, 1) && in_contact(a, b, 2)) {
+                _pairs.emplace_back(a, b);
+                _pairs.emplace_back(b, a);
+            }
+        }
+    }
+
+    std::ranges::sort(_pairs);
+
+    _offsets.assign(num_pieces + 1, 0);
+    _contacts.clear();
+
+    for (const auto& [piece, contact] : _pairs) {
+        _offsets[piece + 1]++;
+        _contacts.push_back(contact);
+    }
+
+    for (size_t i = 1; i < _offsets.size(); i++) {
+        _offsets[i] += _offsets[i - 1];
+    }
+}
+
+void ContactIndex::reserve(size_t num_pieces)
+{
+    _order.reserve(num_pieces);
+    _pairs.reserve(num_pieces * num_pieces);
+    _offsets.reserve(num_pieces + 1);
+    _contacts.reserve(num_pieces * num_pieces);
+}
+
+std::span<const uint32_t> ContactIndex::get_contacts(size_t piece) const noexcept
+{
+    return std::span(_contacts).subspan(_offsets[piece], _offsets[piece + 1] - _offsets[piece]);
+}
+
+size_t ContactIndex::get_num_pairs() const noexcept
+{
+    return _pairs.size() / 2;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "utils.h"
+
+// Pieces of a state whose bounding boxes are at most one voxel apart, the only pairs that can block each
+// other in a unit move. Built by a sweep over the boxes sorted along x; the buffers are reused between builds.
+class ContactIndex final
+{
+public:
+    // Pieces flagged in `excluded` get no contacts and appear in no list
+    void build(const std::vector<utils::int3>& positions, const std::vector<utils::int3>& extents, const std::vector<bool>& excluded) noexcept;
+
+    // Grows the buffers for the worst case of a puzzle, so later builds do not allocate
+    void reserve(size_t num_pieces);
+
+    // Contacts of a piece in ascending order
+    [[nodiscard]] std::span<const uint32_t> get_contacts(size_t piece) const noexcept;
+    [[nodiscard]] size_t get_num_pairs() const noexcept;
+
+private:
+    std::vector<uint32_t> _order;
+    std::vector<std::pair<uint32_t, uint32_t>> _pairs;
+
+    // Contacts of piece i are _contacts[_offsets[i], _offsets[i + 1])
+    std::vector<uint32_t> _offsets;
+    std::vector<uint32_t> _contacts;
+};
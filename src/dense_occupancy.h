@@ -0,0 +1,96 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "piece.h"
+#include "row_kernels.h"
+#include "utils.h"
+
+// Occupancy of the whole grid as N x N row bitboards, the fastest choice while the grid is small.
+// Voxels beyond the grid are dropped on every axis, so nothing past an edge can collide.
+template <size_t N>
+class DenseField final
+{
+public:
+    void clear() noexcept
+    {
+        _rows.fill(0);
+    }
+
+    void add(const Piece<N>& piece, utils::int3 position) noexcept
+    {
+        _update(piece, position, [](uint64_t& row, uint64_t bits) { row |= bits; });
+    }
+
+    void remove(const Piece<N>& piece, utils::int3 position) noexcept
+    {
+        _update(piece, position, [](uint64_t& row, uint64_t bits) { row &= ~bits; });
+    }
+
+    [[nodiscard]] bool overlaps(const Piece<N>& piece, utils::int3 position) const noexcept
+    {
+        const auto& offsets = piece.get_row_offsets();
+        const auto& bits = piece.get_row_bits();
+
+        if (_is_inside(piece, position))
+            return row_kernels::overlaps(_rows.data(), offsets.data(), bits.data(), offsets.size(), _get_base(position), position.x);
+
+        for (size_t i = 0; i < offsets.size(); i++) {
+            const size_t row = _get_row(offsets[i], position);
+
+            if (row < _rows.size() && (_rows[row] & row_kernels::shift_row(bits[i], position.x)))
+                return true;
+        }
+
+        return false;
+    }
+
+private:
+    // Columns of a row inside the grid. Bits past it are never stored, so collision tests need no mask.
+    static constexpr uint64_t row_mask = N < 64 ? (uint64_t(1) << N) - 1 : ~uint64_t(0);
+
+    [[nodiscard]] static bool _is_inside(const Piece<N>& piece, utils::int3 position) noexcept
+    {
+        const utils::int3 extent = piece.get_extent();
+
+        return position.y + extent.y <= static_cast<int>(N) && position.z + extent.z <= static_cast<int>(N);
+    }
+
+    [[nodiscard]] static uint32_t _get_base(utils::int3 position) noexcept
+    {
+        return static_cast<uint32_t>(position.y + position.z * static_cast<int>(N));
+    }
+
+    // Index of a piece row in the field, past the end if the row lies beyond the grid
+    [[nodiscard]] static size_t _get_row(uint32_t offset, utils::int3 position) noexcept
+    {
+        const size_t y = offset % N + static_cast<size_t>(position.y);
+        const size_t z = offset / N + static_cast<size_t>(position.z);
+
+        return y < N && z < N ? y + z * N : N * N;
+    }
+
+    template <typename Operation>
+    void _update(const Piece<N>& piece, utils::int3 position, Operation operation) noexcept
+    {
+        const auto& offsets = piece.get_row_offsets();
+        const auto& bits = piece.get_row_bits();
+
+        for (size_t i = 0; i < offsets.size(); i++) {
+            const size_t row = _get_row(offsets[i], position);
+
+            if (row < _rows.size())
+                operation(_rows[row], row_kernels::shift_row(bits[i], position.x) & row_mask);
+        }
+    }
+
+    std::array<uint64_t, N * N> _rows = {};
+};
+
+template <size_t N>
+struct DenseOccupancy
+{
+    using Piece = ::Piece<N>;
+    using Field = DenseField<N>;
+};
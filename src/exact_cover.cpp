@@ -0,0 +1,304 @@
+#include "exact_cover.h"
+
+#include <limits>
+
+ExactCover::ExactCover(std::vector<uint32_t> multiplicities, size_t num_secondary_columns) noexcept
+{
+    const size_t num_primary_columns = multiplicities.size();
+    const size_t num_columns = num_primary_columns + num_secondary_columns;
+
+    _left.resize(num_columns + 1);
+    _right.resize(num_columns + 1);
+    _up.resize(num_columns + 1);
+    _down.resize(num_columns + 1);
+    _column.resize(num_columns + 1);
+    _row.assign(num_columns + 1, -1);
+    _sizes.assign(num_columns + 1, 0);
+    _remaining.assign(num_columns + 1, 1);
+
+    for (size_t i = 0; i <= num_columns; i++) {
+        const int node = static_cast<int>(i);
+
+        _up[i] = node;
+        _down[i] = node;
+        _column[i] = node;
+        _left[i] = node;
+        _right[i] = node;
+    }
+
+    // Only primary columns are linked into the header list, secondary columns never get branched on
+    for (size_t i = 1; i <= num_primary_columns; i++) {
+        const int node = static_cast<int>(i);
+
+        _left[i] = _left[root];
+        _right[i] = root;
+        _right[_left[root]] = node;
+        _left[root] = node;
+        _remaining[i] = multiplicities[i - 1];
+    }
+}
+
+size_t ExactCover::add_row(std::span<const int> columns) noexcept
+{
+    const int row = static_cast<int>(_num_rows++);
+    int first = -1;
+
+    for (int column_index : columns) {
+        const int column = column_index + 1;
+        const int node = static_cast<int>(_column.size());
+
+        _column.push_back(column);
+        _row.push_back(row);
+        _up.push_back(_up[column]);
+        _down.push_back(column);
+        _down[_up[column]] = node;
+        _up[column] = node;
+        _sizes[column]++;
+
+        if (first < 0) {
+            first = node;
+            _left.push_back(node);
+            _right.push_back(node);
+        } else {
+            _left.push_back(_left[first]);
+            _right.push_back(first);
+            _right[_left[first]] = node;
+            _left[first] = node;
+        }
+    }
+
+    return static_cast<size_t>(row);
+}
+
+void ExactCover::search(const std::function<bool(const std::vector<int>&)>& on_solution) noexcept
+{
+    (void)_search(on_solution);
+}
+
+size_t ExactCover::get_num_branches() const noexcept
+{
+    if (is_solved())
+        return 0;
+
+    const int column = _choose_column();
+
+    return column < 0 ? 0 : static_cast<size_t>(_sizes[column]);
+}
+
+bool ExactCover::is_solved() const noexcept
+{
+    return _right[root] == root;
+}
+
+void ExactCover::descend(size_t branch) noexcept
+{
+    const int column = _choose_column();
+    Step step = {_down[column], {}};
+
+    // Same state search() is in when it reaches this branch, earlier interchangeable rows are hidden
+    for (size_t i = 0; i < branch; i++) {
+        if (_remaining[column] > 1) {
+            _hide_row(step.node);
+            step.hidden.push_back(step.node);
+        }
+
+        step.node = _down[step.node];
+    }
+
+    _select(step.node);
+    _solution.push_back(_row[step.node]);
+    _steps.push_back(std::move(step));
+}
+
+void ExactCover::ascend() noexcept
+{
+    Step& step = _steps.back();
+
+    _solution.pop_back();
+    _unselect(step.node);
+
+    for (auto it = step.hidden.rbegin(); it != step.hidden.rend(); ++it) {
+        _unhide_row(*it);
+    }
+
+    _steps.pop_back();
+}
+
+void ExactCover::set_stop_flag(const std::atomic<bool>* stop) noexcept
+{
+    _stop = stop;
+}
+
+size_t ExactCover::get_num_rows() const noexcept
+{
+    return _num_rows;
+}
+
+size_t ExactCover::get_num_columns() const noexcept
+{
+    return _sizes.size() - 1;
+}
+
+uint64_t ExactCover::get_num_search_nodes() const noexcept
+{
+    return _num_search_nodes;
+}
+
+bool ExactCover::_search(const std::function<bool(const std::vector<int>&)>& on_solution) noexcept
+{
+    if (_right[root] == root)
+        return on_solution(_solution);
+
+    _num_search_nodes++;
+
+    if (_stop && _stop->load(std::memory_order_relaxed))
+        return false;
+
+    const int column = _choose_column();
+
+    if (column < 0)
+        return true;
+
+    // Rows of interchangeable items are tried in list order and excluded once tried, so the search only
+    // ever picks them in increasing order and each multiset of rows is found once
+    const bool interchangeable = _remaining[column] > 1;
+    std::vector<int> hidden;
+
+    bool running = true;
+
+    for (int node = _down[column]; node != column; node = _down[node]) {
+        _select(node);
+        _solution.push_back(_row[node]);
+
+        running = _search(on_solution);
+
+        _solution.pop_back();
+        _unselect(node);
+
+        if (!running)
+            break;
+
+        if (interchangeable) {
+            _hide_row(node);
+            hidden.push_back(node);
+        }
+    }
+
+    for (auto it = hidden.rbegin(); it != hidden.rend(); ++it) {
+        _unhide_row(*it);
+    }
+
+    return running;
+}
+
+int ExactCover::_choose_column() const noexcept
+{
+    int best = -1;
+    int best_branches = std::numeric_limits<int>::max();
+
+    for (int column = _right[root]; column != root; column = _right[column]) {
+        const int remaining = static_cast<int>(_remaining[column]);
+
+        // Not enough rows left to cover the column as often as required
+        if (_sizes[column] < remaining)
+            return -1;
+
+        const int branches = _sizes[column] - remaining + 1;
+
+        if (branches < best_branches) {
+            best = column;
+            best_branches = branches;
+
+            if (branches == 1)
+                break;
+        }
+    }
+
+    return best;
+}
+
+void ExactCover::_select(int row_node) noexcept
+{
+    int node = row_node;
+
+    do {
+        _apply(_column[node]);
+        node = _right[node];
+    } while (node != row_node);
+}
+
+void ExactCover::_unselect(int row_node) noexcept
+{
+    int node = _left[row_node];
+
+    while (node != row_node) {
+        _unapply(_column[node]);
+        node = _left[node];
+    }
+
+    _unapply(_column[row_node]);
+}
+
+void ExactCover::_apply(int column) noexcept
+{
+    if (_remaining[column]-- == 1)
+        _cover(column);
+}
+
+void ExactCover::_unapply(int column) noexcept
+{
+    if (_remaining[column]++ == 0)
+        _uncover(column);
+}
+
+void ExactCover::_cover(int column) noexcept
+{
+    _left[_right[column]] = _left[column];
+    _right[_left[column]] = _right[column];
+
+    for (int row = _down[column]; row != column; row = _down[row]) {
+        for (int node = _right[row]; node != row; node = _right[node]) {
+            _up[_down[node]] = _up[node];
+            _down[_up[node]] = _down[node];
+            _sizes[_column[node]]--;
+        }
+    }
+}
+
+void ExactCover::_uncover(int column) noexcept
+{
+    for (int row = _up[column]; row != column; row = _up[row]) {
+        for (int node = _left[row]; node != row; node = _left[node]) {
+            _sizes[_column[node]]++;
+            _up[_down[node]] = node;
+            _down[_up[node]] = node;
+        }
+    }
+
+    _left[_right[column]] = column;
+    _right[_left[column]] = column;
+}
+
+void ExactCover::_hide_row(int row_node) noexcept
+{
+    int node = row_node;
+
+    do {
+        _up[_down[node]] = _up[node];
+        _down[_up[node]] = _down[node];
+        _sizes[_column[node]]--;
+        node = _right[node];
+    } while (node != row_node);
+}
+
+void ExactCover::_unhide_row(int row_node) noexcept
+{
+    int node = _left[row_node];
+
+    do {
+        _sizes[_column[node]]++;
+        _up[_down[node]] = node;
+        _down[_up[node]] = node;
+        node = _left[node];
+    } while (node != _left[row_node]);
+}
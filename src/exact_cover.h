@@ -0,0 +1,76 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <vector>
+
+// Dancing Links exact cover. Primary columns have to be covered exactly as often as their multiplicity,
+// secondary columns at most once. Columns with a multiplicity above one describe interchangeable items,
+// e.g. identical pieces, and every solution is reported once instead of once per permutation.
+class ExactCover final
+{
+public:
+    ExactCover(std::vector<uint32_t> multiplicities, size_t num_secondary_columns) noexcept;
+
+    // Columns of a row must be distinct, returns the row index
+    size_t add_row(std::span<const int> columns) noexcept;
+
+    // Reports every solution below the current search node as a list of row indices, including the rows
+    // selected with descend(). The callback returns false to stop the search.
+    void search(const std::function<bool(const std::vector<int>&)>& on_solution) noexcept;
+
+    // Steps into the branch-th child of the current search node and back. The children are in the order
+    // search() visits them, so a list of branch indices names a subtree, e.g. to split the search into tasks.
+    [[nodiscard]] size_t get_num_branches() const noexcept;
+    [[nodiscard]] bool is_solved() const noexcept;
+    void descend(size_t branch) noexcept;
+    void ascend() noexcept;
+
+    // search() returns early once the flag is set
+    void set_stop_flag(const std::atomic<bool>* stop) noexcept;
+
+    [[nodiscard]] size_t get_num_rows() const noexcept;
+    [[nodiscard]] size_t get_num_columns() const noexcept;
+    [[nodiscard]] uint64_t get_num_search_nodes() const noexcept;
+
+private:
+    [[nodiscard]] bool _search(const std::function<bool(const std::vector<int>&)>& on_solution) noexcept;
+    [[nodiscard]] int _choose_column() const noexcept;
+
+    void _select(int row_node) noexcept;
+    void _unselect(int row_node) noexcept;
+    void _apply(int column) noexcept;
+    void _unapply(int column) noexcept;
+    void _cover(int column) noexcept;
+    void _uncover(int column) noexcept;
+    void _hide_row(int row_node) noexcept;
+    void _unhide_row(int row_node) noexcept;
+
+private:
+    static constexpr int root = 0;
+
+    // Node 0 is the root, nodes 1..columns are the column headers, row nodes follow
+    std::vector<int> _left;
+    std::vector<int> _right;
+    std::vector<int> _up;
+    std::vector<int> _down;
+    std::vector<int> _column;
+    std::vector<int> _row;
+
+    std::vector<int> _sizes;
+    std::vector<uint32_t> _remaining;
+    size_t _num_rows = 0;
+
+    struct Step
+    {
+        int node;
+        std::vector<int> hidden;
+    };
+
+    std::vector<int> _solution;
+    std::vector<Step> _steps;
+    uint64_t _num_search_nodes = 0;
+    const std::atomic<bool>* _stop = nullptr;
+};
@@ -0,0 +1,22 @@
+#include "json.h"
+
+#include <fmt/format.h>
+
+std::string escape_json(const std::string& text)
+{
+    std::string escaped;
+    escaped.reserve(text.size());
+
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            escaped.push_back('\\');
+            escaped.push_back(c);
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            escaped += fmt::format("\\u{:04x}", static_cast<unsigned char>(c));
+        } else {
+            escaped.push_back(c);
+        }
+    }
+
+    return escaped;
+}
@@ -0,0 +1,6 @@
+#pragma once
+
+#include <string>
+
+// Escapes text for a JSON string literal, control characters are written as \u00XX
+[[nodiscard]] std::string escape_json(const std::string& text);
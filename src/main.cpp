@@ -6,7 +6,7 @@ int main(int argc, char** argv) {
     
     auto app = new Application();
 
-    app->init_wizard(file_path);
+    app->init_wizard(argc > 1 ? std::filesystem::path(argv[1]) : file_path);
     app->run();
     
     delete app;
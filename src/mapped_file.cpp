@@ -0,0 +1,124 @@
+#include "mapped_file.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile() noexcept
+{
+    close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const std::filesystem::path& path) noexcept
+{
+    close();
+
+    _file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+    if (_file == INVALID_HANDLE_VALUE) {
+        _file = nullptr;
+        return false;
+    }
+
+    LARGE_INTEGER size;
+
+    if (!GetFileSizeEx(_file, &size) || size.QuadPart == 0) {
+        close();
+        return false;
+    }
+
+    _mapping = CreateFileMappingW(_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+    if (!_mapping) {
+        close();
+        return false;
+    }
+
+    _data = static_cast<const std::byte*>(MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0));
+    _size = static_cast<size_t>(size.QuadPart);
+
+    if (!_data) {
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+void MappedFile::close() noexcept
+{
+    if (_data)
+        UnmapViewOfFile(_data);
+
+    if (_mapping)
+        CloseHandle(_mapping);
+
+    if (_file)
+        CloseHandle(_file);
+
+    _data = nullptr;
+    _size = 0;
+    _mapping = nullptr;
+    _file = nullptr;
+}
+
+#else
+
+bool MappedFile::open(const std::filesystem::path& path) noexcept
+{
+    close();
+
+    int file = ::open(path.c_str(), O_RDONLY);
+
+    if (file < 0)
+        return false;
+
+    struct stat status;
+
+    if (fstat(file, &status) != 0 || status.st_size == 0) {
+        ::close(file);
+        return false;
+    }
+
+    // The mapping stays valid after the descriptor is closed
+    void* data = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+    ::close(file);
+
+    if (data == MAP_FAILED)
+        return false;
+
+    _data = static_cast<const std::byte*>(data);
+    _size = static_cast<size_t>(status.st_size);
+
+    return true;
+}
+
+void MappedFile::close() noexcept
+{
+    if (_data)
+        munmap(const_cast<std::byte*>(_data), _size);
+
+    _data = nullptr;
+    _size = 0;
+}
+
+#endif
+
+const std::byte* MappedFile::data() const noexcept
+{
+    return _data;
+}
+
+size_t MappedFile::size() const noexcept
+{
+    return _size;
+}
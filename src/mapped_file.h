@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+
+// Read-only memory mapping of a whole file
+class MappedFile final
+{
+public:
+    MappedFile() = default;
+    ~MappedFile() noexcept;
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    [[nodiscard]] bool open(const std::filesystem::path& path) noexcept;
+    void close() noexcept;
+
+    [[nodiscard]] const std::byte* data() const noexcept;
+    [[nodiscard]] size_t size() const noexcept;
+
+private:
+    const std::byte* _data = nullptr;
+    size_t _size = 0;
+
+#ifdef _WIN32
+    void* _file = nullptr;
+    void* _mapping = nullptr;
+#endif
+};
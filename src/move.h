@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "utils.h"
+
+// A single step of a disassembly: every piece in `group` slides `distance` units along `axis`
+struct Move final
+{
+    uint64_t group = 0;
+    int axis = 0;
+    int distance = 0;
+
+    [[nodiscard]] bool contains(size_t piece) const noexcept
+    {
+        return (group >> piece) & 1;
+    }
+
+    void apply(std::vector<utils::int3>& positions) const noexcept
+    {
+        for (size_t i = 0; i < positions.size(); i++) {
+            if (contains(i))
+                positions[i][axis] += distance;
+        }
+    }
+
+    void revert(std::vector<utils::int3>& positions) const noexcept
+    {
+        for (size_t i = 0; i < positions.size(); i++) {
+            if (contains(i))
+                positions[i][axis] -= distance;
+        }
+    }
+
+    // Every neighbor the solver generates shifts a single component, so the delta of any moved piece describes the
+    // whole move
+    [[nodiscard]] static Move from_positions(const std::vector<utils::int3>& from, const std::vector<utils::int3>& to) noexcept
+    {
+        Move move;
+
+        for (size_t i = 0; i < from.size(); i++) {
+            if (from[i] == to[i])
+                continue;
+
+            move.group |= uint64_t(1) << i;
+
+            for (size_t axis = 0; axis < 3; axis++) {
+                if (from[i][axis] != to[i][axis]) {
+                    move.axis = static_cast<int>(axis);
+                    move.distance = to[i][axis] - from[i][axis];
+                }
+            }
+        }
+
+        return move;
+    }
+};
@@ -1,13 +1,41 @@
 #include "node.h"
+#include <algorithm>
 #include <iostream>
+#include <limits>
+#include <tuple>
 
-Node::Node(std::vector<utils::int3> positions, int dim) noexcept
+namespace
+{
+    auto key_order(const utils::int3& v)
+    {
+        return std::tuple(v.x, v.y, v.z);
+    }
+
+    void sort_identical_pieces(std::vector<utils::int3>& key, const std::vector<std::vector<size_t>>& identical_pieces, std::vector<utils::int3>& scratch)
+    {
+        for (const auto& group : identical_pieces) {
+            scratch.clear();
+
+            for (size_t piece : group) {
+                scratch.push_back(key[piece]);
+            }
+
+            std::ranges::sort(scratch, {}, key_order);
+
+            for (size_t i = 0; i < group.size(); i++) {
+                key[group[i]] = scratch[i];
+            }
+        }
+    }
+}
+
+Node::Node(std::vector<utils::int3> positions, int dim, const StateSymmetries* symmetries) noexcept
     : _dim(dim), _positions(std::move(positions)) 
 {
     _calculate_priority();
     _calculate_free_pieces();
     _calculate_min();
-    _calculate_key();
+    _calculate_key(symmetries);
 }
 
 const std::vector<utils::int3>& Node::get_positions() const noexcept
@@ -25,6 +53,18 @@ const std::vector<bool>& Node::get_free_pieces() const noexcept
     return _free_pieces;
 }
 
+int Node::get_priority() const noexcept
+{
+    return _priority;
+}
+
+size_t Node::get_heap_usage() const noexcept
+{
+    size_t bytes = (_positions.capacity() + _key.capacity()) * sizeof(utils::int3) + (_free_pieces.capacity() + 7) / 8;
+
+    return bytes + 3 * utils::allocation_overhead;
+}
+
 bool Node::operator==(const Node& other) const
 {
     for (size_t i = 0; i < _positions.size(); i++) {
@@ -59,34 +99,43 @@ void Node::print_positions() const noexcept
     std::cout << std::endl;
 }
 
-void Node::_calculate_priority() noexcept
+int Node::calculate_priority(const std::vector<utils::int3>& positions, int dim) noexcept
 {
-    _priority = 0;
+    int priority = 0;
     
-    for (auto& _position : _positions) {
-        _priority += std::min({_position.x, _position.y, _position.z, _dim - _position.x, _dim - _position.y, _dim - _position.z});
+    for (auto& position : positions) {
+        priority += std::min({position.x, position.y, position.z, dim - position.x, dim - position.y, dim - position.z});
     }
+
+    return priority;
 }
 
-void Node::_calculate_free_pieces() noexcept
+void Node::_calculate_priority() noexcept
 {
-    for (auto& position : _positions) {
-        if (position.x < _distance_to_edge || position.x > _dim - _distance_to_edge) {
-            _free_pieces.push_back(true);
-            continue;
-        }
-        
-        if (position.y < _distance_to_edge || position.y > _dim - _distance_to_edge) {
-            _free_pieces.push_back(true);
-            continue;
-        }
+    _priority = calculate_priority(_positions, _dim);
+}
 
-        if (position.z < _distance_to_edge || position.z > _dim - _distance_to_edge) {
-            _free_pieces.push_back(true);
-            continue;
-        }
+size_t Node::count_free_pieces(const std::vector<utils::int3>& positions, int dim) noexcept
+{
+    return static_cast<size_t>(std::ranges::count_if(positions, [&](const utils::int3& position) { return _is_free(position, dim); }));
+}
 
-        _free_pieces.push_back(false);
+bool Node::_is_free(const utils::int3& position, int dim) noexcept
+{
+    for (size_t axis = 0; axis < 3; axis++) {
+        if (position[axis] < distance_to_edge || position[axis] > dim - distance_to_edge)
+            return true;
+    }
+
+    return false;
+}
+
+void Node::_calculate_free_pieces() noexcept
+{
+    _free_pieces.reserve(_positions.size());
+
+    for (auto& position : _positions) {
+        _free_pieces.push_back(_is_free(position, _dim));
     }
 }
 
@@ -105,8 +154,10 @@ void Node::_calculate_min() noexcept
     }
 }
 
-void Node::_calculate_key() noexcept
+void Node::_calculate_key(const StateSymmetries* symmetries) noexcept
 {
+    _key.reserve(_positions.size());
+
     for (size_t i = 0; i < _positions.size(); i++) {
         if (!_free_pieces[i]) {
             _key.push_back({_positions[i].x - _min.x, _positions[i].y - _min.y, _positions[i].z - _min.z});
@@ -114,4 +165,44 @@ void Node::_calculate_key() noexcept
             _key.push_back({0, 0, 0});
         }
     }
+
+    if (!symmetries)
+        return;
+
+    // Kept per thread, so building nodes only allocates the vectors the node keeps
+    thread_local std::vector<utils::int3> scratch;
+    thread_local std::vector<utils::int3> image;
+    thread_local std::vector<bool> image_free;
+
+    sort_identical_pieces(_key, symmetries->identical_pieces, scratch);
+
+    if (symmetries->rotations.empty())
+        return;
+
+    image.resize(_positions.size());
+    image_free.resize(_positions.size());
+
+    for (const auto& symmetry : symmetries->rotations) {
+        utils::int3 min = {std::numeric_limits<int>::max(), std::numeric_limits<int>::max(), std::numeric_limits<int>::max()};
+
+        for (size_t i = 0; i < _positions.size(); i++) {
+            const size_t target = symmetry.permutation[i];
+            image_free[target] = _free_pieces[i];
+
+            if (_free_pieces[i])
+                continue;
+
+            image[target] = orientation::rotate(symmetry.rotation, _positions[i]) + symmetry.offsets[i];
+            min = {std::min(min.x, image[target].x), std::min(min.y, image[target].y), std::min(min.z, image[target].z)};
+        }
+
+        for (size_t i = 0; i < image.size(); i++) {
+            image[i] = image_free[i] ? utils::int3{0, 0, 0} : utils::int3{image[i].x - min.x, image[i].y - min.y, image[i].z - min.z};
+        }
+
+        sort_identical_pieces(image, symmetries->identical_pieces, scratch);
+
+        if (std::ranges::lexicographical_compare(image, _key, {}, key_order, key_order))
+            _key = image;
+    }
 }
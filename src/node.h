@@ -2,17 +2,43 @@
 
 #include <vector>
 
+#include "orientation_table.h"
 #include "utils.h"
 
+// Rotation of the whole puzzle onto itself: piece i takes the place of piece permutation[i], which is at
+// rotation * position + offsets[i] when piece i is at position
+struct PuzzleSymmetry
+{
+    orientation::Rotation rotation;
+    std::vector<size_t> permutation;
+    std::vector<utils::int3> offsets;
+};
+
+// Everything that makes different positions the same state, detected once per puzzle
+struct StateSymmetries
+{
+    // Groups of pieces with the same unit cubes, their positions are listed sorted in the key
+    std::vector<std::vector<size_t>> identical_pieces;
+
+    // Without the identity, the key is the smallest key of all images
+    std::vector<PuzzleSymmetry> rotations;
+};
+
 class Node final
 {
 public:
     Node() = default;
-    Node(std::vector<utils::int3> positions, int dim) noexcept;
+    Node(std::vector<utils::int3> positions, int dim, const StateSymmetries* symmetries = nullptr) noexcept;
 
     [[nodiscard]] const std::vector<utils::int3>& get_positions() const noexcept;
     [[nodiscard]] const std::vector<utils::int3>& get_key() const noexcept;
     [[nodiscard]] const std::vector<bool>& get_free_pieces() const noexcept;
+    [[nodiscard]] int get_priority() const noexcept;
+    [[nodiscard]] size_t get_heap_usage() const noexcept;
+
+    // Priority a node with these positions gets, without building it
+    [[nodiscard]] static int calculate_priority(const std::vector<utils::int3>& positions, int dim) noexcept;
+    [[nodiscard]] static size_t count_free_pieces(const std::vector<utils::int3>& positions, int dim) noexcept;
 
     [[nodiscard]] bool operator==(const Node&) const;
     [[nodiscard]] bool operator!=(const Node&) const;
@@ -21,10 +47,15 @@ public:
     void print_positions() const noexcept;
 
 private:
+    // Pieces closer to the border than this have left the puzzle
+    static constexpr int distance_to_edge = 3;
+
+    [[nodiscard]] static bool _is_free(const utils::int3& position, int dim) noexcept;
+
     void _calculate_priority() noexcept;
     void _calculate_free_pieces() noexcept;
     void _calculate_min() noexcept;
-    void _calculate_key() noexcept;
+    void _calculate_key(const StateSymmetries* symmetries) noexcept;
     
 private:
     int _dim;
@@ -33,7 +64,6 @@ private:
     std::vector<utils::int3> _positions;
     std::vector<utils::int3> _key;
 
-    int _distance_to_edge = 3;
     std::vector<bool> _free_pieces;
 
     utils::int3 _min;
@@ -0,0 +1,149 @@
+#include "orientation_table.h"
+
+#include <algorithm>
+#include <tuple>
+
+namespace
+{
+    std::vector<orientation::Rotation> generate_rotations()
+    {
+        std::vector<orientation::Rotation> rotations;
+        std::array<int, 3> axes = {0, 1, 2};
+
+        // Signed permutation matrices with determinant +1, the identity comes first
+        do {
+            for (int signs = 0; signs < 8; signs++) {
+                orientation::Rotation rotation = {};
+
+                for (size_t row = 0; row < 3; row++) {
+                    rotation[row][static_cast<size_t>(axes[row])] = (signs >> row) & 1 ? -1 : 1;
+                }
+
+                const auto& [a, b, c] = rotation;
+                const int determinant = a.x * (b.y * c.z - b.z * c.y) - a.y * (b.x * c.z - b.z * c.x) + a.z * (b.x * c.y - b.y * c.x);
+
+                if (determinant == 1)
+                    rotations.push_back(rotation);
+            }
+        } while (std::next_permutation(axes.begin(), axes.end()));
+
+        return rotations;
+    }
+
+    utils::int3 get_size(const std::vector<utils::int3>& cubes)
+    {
+        if (cubes.empty())
+            return {0, 0, 0};
+
+        const utils::int3 min = orientation::get_min(cubes);
+        utils::int3 size = {0, 0, 0};
+
+        for (const auto& cube : cubes) {
+            size = {std::max(size.x, cube.x - min.x + 1), std::max(size.y, cube.y - min.y + 1), std::max(size.z, cube.z - min.z + 1)};
+        }
+
+        return size;
+    }
+}
+
+namespace orientation
+{
+    const std::vector<Rotation>& get_rotations() noexcept
+    {
+        static const std::vector<Rotation> rotations = generate_rotations();
+        return rotations;
+    }
+
+    utils::int3 rotate(const Rotation& rotation, utils::int3 v) noexcept
+    {
+        auto dot = [&](const utils::int3& row) { return row.x * v.x + row.y * v.y + row.z * v.z; };
+        return {dot(rotation[0]), dot(rotation[1]), dot(rotation[2])};
+    }
+
+    utils::int3 get_min(const std::vector<utils::int3>& cubes) noexcept
+    {
+        utils::int3 min = cubes.front();
+
+        for (const auto& cube : cubes) {
+            min = {std::min(min.x, cube.x), std::min(min.y, cube.y), std::min(min.z, cube.z)};
+        }
+
+        return min;
+    }
+
+    void sort_grid_order(std::vector<utils::int3>& cubes) noexcept
+    {
+        std::ranges::sort(cubes, {}, [](const utils::int3& v) { return std::tuple(v.z, v.y, v.x); });
+    }
+
+    bool less_grid_order(const std::vector<utils::int3>& a, const std::vector<utils::int3>& b) noexcept
+    {
+        auto key = [](const utils::int3& v) { return std::tuple(v.z, v.y, v.x); };
+        return std::ranges::lexicographical_compare(a, b, {}, key, key);
+    }
+
+    std::vector<utils::int3> normalize(std::vector<utils::int3> cubes) noexcept
+    {
+        const utils::int3 min = get_min(cubes);
+
+        for (auto& cube : cubes) {
+            cube = {cube.x - min.x, cube.y - min.y, cube.z - min.z};
+        }
+
+        sort_grid_order(cubes);
+
+        return cubes;
+    }
+}
+
+OrientationTable::OrientationTable(const std::vector<utils::int3>& cubes) noexcept
+    : _size(::get_size(cubes))
+{
+    if (cubes.empty())
+        return;
+
+    const auto& rotations = orientation::get_rotations();
+    const std::vector<utils::int3> shape = orientation::normalize(cubes);
+
+    for (size_t r = 0; r < rotations.size(); r++) {
+        std::vector<utils::int3> rotated;
+
+        for (const auto& cube : cubes) {
+            rotated.push_back(orientation::rotate(rotations[r], cube));
+        }
+
+        rotated = orientation::normalize(std::move(rotated));
+
+        if (rotated == shape)
+            _symmetry_group.push_back(static_cast<uint8_t>(r));
+
+        auto it = std::ranges::find(_orientations, rotated, &Orientation::cubes);
+
+        if (it == _orientations.end())
+            it = _orientations.insert(_orientations.end(), {rotated, ::get_size(rotated), {}});
+
+        it->rotations.push_back(static_cast<uint8_t>(r));
+    }
+
+    std::ranges::sort(_orientations, orientation::less_grid_order, &Orientation::cubes);
+}
+
+const std::vector<Orientation>& OrientationTable::get_orientations() const noexcept
+{
+    return _orientations;
+}
+
+const Orientation& OrientationTable::get_canonical() const noexcept
+{
+    return _orientations.front();
+}
+
+const std::vector<uint8_t>& OrientationTable::get_symmetry_group() const noexcept
+{
+    return _symmetry_group;
+}
+
+utils::int3 OrientationTable::get_size() const noexcept
+{
+    return _size;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "utils.h"
+
+namespace orientation
+{
+    // Rows of a rotation matrix
+    using Rotation = std::array<utils::int3, 3>;
+
+    // The 24 proper rotations of the cube, the identity comes first
+    [[nodiscard]] const std::vector<Rotation>& get_rotations() noexcept;
+    [[nodiscard]] utils::int3 rotate(const Rotation& rotation, utils::int3 v) noexcept;
+
+    [[nodiscard]] utils::int3 get_min(const std::vector<utils::int3>& cubes) noexcept;
+    void sort_grid_order(std::vector<utils::int3>& cubes) noexcept;
+    [[nodiscard]] bool less_grid_order(const std::vector<utils::int3>& a, const std::vector<utils::int3>& b) noexcept;
+
+    // Moves the minimum corner to the origin and sorts in grid order, so equal shapes compare equal
+    [[nodiscard]] std::vector<utils::int3> normalize(std::vector<utils::int3> cubes) noexcept;
+}
+
+// A distinct orientation of a shape: normalized unit cubes in grid order and their bounding box
+struct Orientation
+{
+    std::vector<utils::int3> cubes;
+    utils::int3 size = {0, 0, 0};
+
+    // Indices into orientation::get_rotations() of every rotation that turns the shape into this orientation
+    std::vector<uint8_t> rotations;
+};
+
+// All orientations of a shape computed once. Symmetric shapes have fewer than 24, the orientations are
+// sorted in grid order, so the first one is the canonical form shared by every rotation of the shape.
+class OrientationTable final
+{
+public:
+    OrientationTable() = default;
+    explicit OrientationTable(const std::vector<utils::int3>& cubes) noexcept;
+
+    [[nodiscard]] const std::vector<Orientation>& get_orientations() const noexcept;
+    [[nodiscard]] const Orientation& get_canonical() const noexcept;
+
+    // Rotations that map the shape onto itself, the identity included
+    [[nodiscard]] const std::vector<uint8_t>& get_symmetry_group() const noexcept;
+
+    // Bounding box of the shape as given
+    [[nodiscard]] utils::int3 get_size() const noexcept;
+
+private:
+    std::vector<Orientation> _orientations;
+    std::vector<uint8_t> _symmetry_group;
+    utils::int3 _size = {0, 0, 0};
+};
@@ -1,43 +1,71 @@
 #pragma once
 
-#include <bitset>
-#include <unordered_map>
+#include <algorithm>
+#include <cstdint>
+#include <vector>
 
+#include "row_kernels.h"
 #include "utils.h"
 
+// Piece as row bitboards of its bounding box: one word per (y, z) row with bit x set for a unit cube.
+// Rows are shifted to the position of the piece when they are tested, so no shifted copies are kept.
 template<size_t N>
 class Piece final
 {
+    static_assert(N <= 64, "A row of the grid has to fit into one word");
+
 public:
-    Piece(std::bitset<N * N * N> bits) noexcept
+    Piece(std::vector<utils::int3> unit_cubes) noexcept
+        : _positions(std::move(unit_cubes))
     {
-        _piece = bits;
-        _generate_positions();
-    }
+        for (const auto& position : _positions) {
+            _extent = {std::max(_extent.x, position.x + 1), std::max(_extent.y, position.y + 1), std::max(_extent.z, position.z + 1)};
+        }
 
-    [[nodiscard]] const std::bitset<N*N*N>& get_bitset(int i) noexcept
-    {
-        auto key = _pieces.find(i);
+        _rows.assign(static_cast<size_t>(_extent.y) * _extent.z, 0);
 
-        if (key == _pieces.end()) {
-            _pieces[i] = _piece << i;
+        for (const auto& position : _positions) {
+            _rows[static_cast<size_t>(position.y + position.z * _extent.y)] |= uint64_t(1) << position.x;
         }
 
-        return _pieces[i];
+        for (int z = 0; z < _extent.z; z++) {
+            for (int y = 0; y < _extent.y; y++) {
+                const uint64_t row = _rows[static_cast<size_t>(y + z * _extent.y)];
+
+                if (row != 0) {
+                    _row_offsets.push_back(static_cast<uint32_t>(y + z * static_cast<int>(N)));
+                    _row_bits.push_back(row);
+                }
+            }
+        }
     }
 
-    [[nodiscard]] const std::bitset<N*N*N>& get_bitset(utils::int3 pos) noexcept
+    [[nodiscard]] bool overlaps(utils::int3 position, const Piece& other, utils::int3 other_position) const noexcept
     {
-        int i = utils::transform_index_3d_to_1d(pos, _dim);
-        auto key = _pieces.find(i);
+        utils::int3 min;
+        utils::int3 max;
+
+        for (size_t axis = 0; axis < 3; axis++) {
+            min[axis] = std::max(position[axis], other_position[axis]);
+            max[axis] = std::min(position[axis] + _extent[axis], other_position[axis] + other._extent[axis]);
 
-        if (key == _pieces.end()) {
-            _pieces[i] = _piece << i;
+            if (min[axis] >= max[axis])
+                return false;
         }
 
-        return _pieces[i];
+        for (int z = min.z; z < max.z; z++) {
+            for (int y = min.y; y < max.y; y++) {
+                const uint64_t row = _get_row(y - position.y, z - position.z);
+                const uint64_t other_row = other._get_row(y - other_position.y, z - other_position.z);
+
+                if (row_kernels::shift_row(row, position.x) & row_kernels::shift_row(other_row, other_position.x))
+                    return true;
+            }
+        }
+
+        return false;
     }
-    
+
     [[nodiscard]] size_t get_num_unit_cubes() const noexcept
     {
         return _positions.size();
@@ -47,24 +75,42 @@ public:
     {
         return _positions;
     }
-    
-private:
-    void _generate_positions() noexcept
+
+    [[nodiscard]] utils::int3 get_extent() const noexcept
     {
-        for (int i = 0; i < _volume; i++) {
-            if (_piece[i]) {
-                utils::int3 pos = utils::transform_index_1d_to_3d(i, N);
-                _positions.push_back(pos);
-            }
-        }
+        return _extent;
+    }
+
+    // Non-empty rows as offsets y + z * N into an N x N grid of rows, and their bits
+    [[nodiscard]] const std::vector<uint32_t>& get_row_offsets() const noexcept
+    {
+        return _row_offsets;
     }
-    
+
+    [[nodiscard]] const std::vector<uint64_t>& get_row_bits() const noexcept
+    {
+        return _row_bits;
+    }
+
+    // Bytes held by the row bitboards
+    [[nodiscard]] size_t get_cache_memory_usage() const noexcept
+    {
+        return _rows.capacity() * sizeof(uint64_t) + _row_offsets.capacity() * sizeof(uint32_t) + _row_bits.capacity() * sizeof(uint64_t) + 3 * utils::allocation_overhead;
+    }
+
 private:
-    size_t _dim = N;
-    size_t _volume = N*N*N;
+    [[nodiscard]] uint64_t _get_row(int y, int z) const noexcept
+    {
+        return _rows[static_cast<size_t>(y + z * _extent.y)];
+    }
+
+    utils::int3 _extent = {0, 0, 0};
+
+    // Every row of the bounding box, including empty ones, for piece against piece tests
+    std::vector<uint64_t> _rows;
 
-    std::bitset<N*N*N> _piece;
-    std::unordered_map<uint32_t, std::bitset<N*N*N>> _pieces;
+    std::vector<uint32_t> _row_offsets;
+    std::vector<uint64_t> _row_bits;
 
     std::vector<utils::int3> _positions;
-};
\ No newline at end of file
+};
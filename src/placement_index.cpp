@@ -0,0 +1,107 @@
+#include "placement_index.h"
+
+#include <algorithm>
+
+CellGrid::CellGrid(std::vector<utils::int3> cells) noexcept
+    : _cells(std::move(cells))
+{
+    orientation::sort_grid_order(_cells);
+    _cells.erase(std::unique(_cells.begin(), _cells.end()), _cells.end());
+
+    if (_cells.empty())
+        return;
+
+    _min = orientation::get_min(_cells);
+
+    for (const auto& cell : _cells) {
+        _extent = {std::max(_extent.x, cell.x - _min.x + 1), std::max(_extent.y, cell.y - _min.y + 1), std::max(_extent.z, cell.z - _min.z + 1)};
+    }
+
+    _lookup.assign(static_cast<size_t>(_extent.x) * _extent.y * _extent.z, -1);
+
+    for (size_t i = 0; i < _cells.size(); i++) {
+        const utils::int3 local = {_cells[i].x - _min.x, _cells[i].y - _min.y, _cells[i].z - _min.z};
+        _lookup[static_cast<size_t>(local.x + local.y * _extent.x + local.z * _extent.x * _extent.y)] = static_cast<int>(i);
+    }
+}
+
+int CellGrid::get_index(utils::int3 position) const noexcept
+{
+    const utils::int3 local = {position.x - _min.x, position.y - _min.y, position.z - _min.z};
+
+    if (local.x < 0 || local.y < 0 || local.z < 0 || local.x >= _extent.x || local.y >= _extent.y || local.z >= _extent.z)
+        return -1;
+
+    return _lookup[static_cast<size_t>(local.x + local.y * _extent.x + local.z * _extent.x * _extent.y)];
+}
+
+const std::vector<utils::int3>& CellGrid::get_cells() const noexcept
+{
+    return _cells;
+}
+
+size_t CellGrid::size() const noexcept
+{
+    return _cells.size();
+}
+
+bool CellGrid::empty() const noexcept
+{
+    return _cells.empty();
+}
+
+utils::int3 CellGrid::get_min() const noexcept
+{
+    return _min;
+}
+
+utils::int3 CellGrid::get_extent() const noexcept
+{
+    return _extent;
+}
+
+PlacementIndex::PlacementIndex(const OrientationTable& table, const CellGrid& grid) noexcept
+{
+    const utils::int3 min = grid.get_min();
+    const utils::int3 extent = grid.get_extent();
+    const auto& orientations = table.get_orientations();
+
+    for (size_t o = 0; o < orientations.size(); o++) {
+        const Orientation& orientation = orientations[o];
+
+        for (int z = 0; z + orientation.size.z <= extent.z; z++) {
+            for (int y = 0; y + orientation.size.y <= extent.y; y++) {
+                for (int x = 0; x + orientation.size.x <= extent.x; x++) {
+                    Placement placement = {static_cast<uint32_t>(o), {min.x + x, min.y + y, min.z + z}, {}};
+
+                    // Cubes and cells are both in grid order, so the cells come out ascending
+                    for (const auto& cube : orientation.cubes) {
+                        const int cell = grid.get_index(cube + placement.translation);
+
+                        if (cell < 0)
+                            break;
+
+                        placement.cells.push_back(cell);
+                    }
+
+                    if (placement.cells.size() != orientation.cubes.size())
+                        continue;
+
+                    _placements.push_back(std::move(placement));
+                }
+            }
+        }
+    }
+
+    std::ranges::stable_sort(_placements, {}, &Placement::get_first_cell);
+}
+
+const std::vector<Placement>& PlacementIndex::get_placements() const noexcept
+{
+    return _placements;
+}
+
+size_t PlacementIndex::size() const noexcept
+{
+    return _placements.size();
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "orientation_table.h"
+#include "utils.h"
+
+// Cells of a target shape in grid order with constant time lookup by position
+class CellGrid final
+{
+public:
+    CellGrid() = default;
+    explicit CellGrid(std::vector<utils::int3> cells) noexcept;
+
+    // Index of the cell at a position, -1 outside the shape
+    [[nodiscard]] int get_index(utils::int3 position) const noexcept;
+
+    [[nodiscard]] const std::vector<utils::int3>& get_cells() const noexcept;
+    [[nodiscard]] size_t size() const noexcept;
+    [[nodiscard]] bool empty() const noexcept;
+    [[nodiscard]] utils::int3 get_min() const noexcept;
+    [[nodiscard]] utils::int3 get_extent() const noexcept;
+
+private:
+    std::vector<utils::int3> _cells;
+    std::vector<int> _lookup;
+    utils::int3 _min = {0, 0, 0};
+    utils::int3 _extent = {0, 0, 0};
+};
+
+// Placement of one orientation at one translation, with its cells in ascending order
+struct Placement
+{
+    uint32_t orientation;
+    utils::int3 translation;
+    std::vector<int> cells;
+
+    [[nodiscard]] int get_first_cell() const noexcept
+    {
+        return cells.front();
+    }
+};
+
+// Every placement of a shape inside a target, sorted by first cell so the exact cover rows of a class
+// come out in grid order
+class PlacementIndex final
+{
+public:
+    PlacementIndex() = default;
+    PlacementIndex(const OrientationTable& table, const CellGrid& grid) noexcept;
+
+    [[nodiscard]] const std::vector<Placement>& get_placements() const noexcept;
+    [[nodiscard]] size_t size() const noexcept;
+
+private:
+    std::vector<Placement> _placements;
+};
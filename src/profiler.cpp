@@ -0,0 +1,112 @@
+#include "profiler.h"
+
+#include <fmt/format.h>
+#include <fmt/os.h>
+
+std::string_view to_string(ProfilePhase phase) noexcept
+{
+    switch (phase) {
+        case ProfilePhase::FieldRebuild: return "field_rebuild";
+        case ProfilePhase::BlockingGraph: return "blocking_graph";
+        case ProfilePhase::StronglyConnectedComponents: return "strongly_connected_components";
+        case ProfilePhase::SlideDistance: return "slide_distance";
+        case ProfilePhase::NodeConstruction: return "node_construction";
+        case ProfilePhase::Hashing: return "hashing";
+        case ProfilePhase::QueueOperations: return "queue_operations";
+        case ProfilePhase::Count: break;
+    }
+
+    return "unknown";
+}
+
+Profiler& Profiler::get() noexcept
+{
+    thread_local Profiler profiler;
+    return profiler;
+}
+
+Profiler::Profiler() noexcept : _epoch(std::chrono::steady_clock::now())
+{
+}
+
+void Profiler::reset() noexcept
+{
+    _epoch = std::chrono::steady_clock::now();
+    _phases = {};
+    _events.clear();
+}
+
+void Profiler::record(ProfilePhase phase, std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end) noexcept
+{
+    auto& statistics = _phases[static_cast<size_t>(phase)];
+    const uint64_t duration_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+
+    statistics.total_ns += duration_ns;
+    statistics.count++;
+
+    if (_trace_sampling == 0 || _events.size() >= _max_events || statistics.count % _trace_sampling != 0)
+        return;
+
+    const uint64_t start_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(start - _epoch).count());
+    _events.push_back({phase, start_ns, duration_ns});
+}
+
+void Profiler::set_trace_sampling(uint32_t every_nth, size_t max_events) noexcept
+{
+    _trace_sampling = every_nth;
+    _max_events = max_events;
+}
+
+const ProfilePhaseStatistics& Profiler::get_phase(ProfilePhase phase) const noexcept
+{
+    return _phases[static_cast<size_t>(phase)];
+}
+
+const std::vector<ProfileEvent>& Profiler::get_events() const noexcept
+{
+    return _events;
+}
+
+std::string Profiler::get_summary() const
+{
+    uint64_t total_ns = 0;
+
+    for (const auto& phase : _phases) {
+        total_ns += phase.total_ns;
+    }
+
+    std::string summary = fmt::format("{:<30} {:>12} {:>10} {:>10} {:>7}\n", "phase", "calls", "total ms", "ns/call", "share");
+
+    for (size_t i = 0; i < _phases.size(); i++) {
+        const auto& phase = _phases[i];
+
+        summary += fmt::format("{:<30} {:>12} {:>10.2f} {:>10.0f} {:>6.1f}%\n", to_string(static_cast<ProfilePhase>(i)), phase.count,
+                               static_cast<double>(phase.total_ns) / 1e6, phase.count ? static_cast<double>(phase.total_ns) / static_cast<double>(phase.count) : 0.0,
+                               total_ns ? 100.0 * static_cast<double>(phase.total_ns) / static_cast<double>(total_ns) : 0.0);
+    }
+
+    return summary;
+}
+
+bool Profiler::write_chrome_trace(const std::filesystem::path& path) const noexcept
+{
+    try {
+        auto file = fmt::output_file(path.string());
+
+        // Complete events ("ph": "X") with microsecond timestamps, as expected by chrome://tracing and Perfetto
+        file.print("{{\"traceEvents\":[\n");
+
+        for (size_t i = 0; i < _events.size(); i++) {
+            const ProfileEvent& event = _events[i];
+
+            file.print(R"({{"name":"{}","ph":"X","pid":1,"tid":1,"ts":{:.3f},"dur":{:.3f}}}{})", to_string(event.phase),
+                       static_cast<double>(event.start_ns) / 1e3, static_cast<double>(event.duration_ns) / 1e3, i + 1 < _events.size() ? ",\n" : "\n");
+        }
+
+        file.print("],\"displayTimeUnit\":\"ms\"}}\n");
+    } catch (const std::exception&) {
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Scoped solver instrumentation. Scopes only exist when BURR_PUZZLE_WIZARD_PROFILE is defined,
+// otherwise BPW_PROFILE_SCOPE expands to nothing and the solver carries no profiling code at all.
+enum class ProfilePhase {
+    FieldRebuild,
+    BlockingGraph,
+    StronglyConnectedComponents,
+    SlideDistance,
+    NodeConstruction,
+    Hashing,
+    QueueOperations,
+    Count
+};
+
+[[nodiscard]] std::string_view to_string(ProfilePhase phase) noexcept;
+
+struct ProfilePhaseStatistics
+{
+    uint64_t total_ns = 0;
+    uint64_t count = 0;
+};
+
+struct ProfileEvent
+{
+    ProfilePhase phase;
+    uint64_t start_ns;
+    uint64_t duration_ns;
+};
+
+// One profiler per thread, so concurrent batch jobs never share counters
+class Profiler final
+{
+public:
+    [[nodiscard]] static Profiler& get() noexcept;
+
+    void reset() noexcept;
+    void record(ProfilePhase phase, std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end) noexcept;
+
+    // Keeps every n-th event per phase for the trace, 0 disables tracing
+    void set_trace_sampling(uint32_t every_nth, size_t max_events = 1 << 20) noexcept;
+
+    [[nodiscard]] const ProfilePhaseStatistics& get_phase(ProfilePhase phase) const noexcept;
+    [[nodiscard]] const std::vector<ProfileEvent>& get_events() const noexcept;
+    [[nodiscard]] std::string get_summary() const;
+    [[nodiscard]] bool write_chrome_trace(const std::filesystem::path& path) const noexcept;
+
+private:
+    Profiler() noexcept;
+
+private:
+    std::chrono::steady_clock::time_point _epoch;
+    std::array<ProfilePhaseStatistics, static_cast<size_t>(ProfilePhase::Count)> _phases;
+
+    uint32_t _trace_sampling = 0;
+    size_t _max_events = 0;
+    std::vector<ProfileEvent> _events;
+};
+
+class ProfileScope final
+{
+public:
+    explicit ProfileScope(ProfilePhase phase) noexcept : _phase(phase), _start(std::chrono::steady_clock::now())
+    {
+    }
+
+    ~ProfileScope() noexcept
+    {
+        Profiler::get().record(_phase, _start, std::chrono::steady_clock::now());
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    ProfilePhase _phase;
+    std::chrono::steady_clock::time_point _start;
+};
+
+#define BPW_PROFILE_CONCAT_IMPL(a, b) a##b
+#define BPW_PROFILE_CONCAT(a, b) BPW_PROFILE_CONCAT_IMPL(a, b)
+
+#ifdef BURR_PUZZLE_WIZARD_PROFILE
+#define BPW_PROFILE_SCOPE(phase) ProfileScope BPW_PROFILE_CONCAT(_profile_scope_, __LINE__)(phase)
+#else
+#define BPW_PROFILE_SCOPE(phase)
+#endif
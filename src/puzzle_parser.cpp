@@ -0,0 +1,224 @@
+#include "puzzle_parser.h"
+
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <tuple>
+#include <fmt/format.h>
+
+namespace
+{
+    // Pieces are addressed through 64-bit masks in moves and blocking graphs
+    constexpr size_t max_pieces = 64;
+
+    bool is_blank(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\r';
+    }
+
+    std::string_view trim(std::string_view text)
+    {
+        while (!text.empty() && is_blank(text.front()))
+            text.remove_prefix(1);
+
+        while (!text.empty() && is_blank(text.back()))
+            text.remove_suffix(1);
+
+        return text;
+    }
+}
+
+PuzzleParser::PuzzleParser(int dim) noexcept : _dim(dim)
+{
+}
+
+bool PuzzleParser::parse_file(const std::filesystem::path& path) noexcept
+{
+    std::ifstream stream(path, std::ios::binary | std::ios::ate);
+
+    if (!stream.is_open()) {
+        _error(0, fmt::format("Could not open {}", path.string()));
+        return false;
+    }
+
+    // Read the whole file with a single call and tokenise in place
+    std::string buffer(static_cast<size_t>(stream.tellg()), '\0');
+    stream.seekg(0);
+    stream.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+
+    if (!stream) {
+        _error(0, fmt::format("Could not read {}", path.string()));
+        return false;
+    }
+
+    return parse(buffer);
+}
+
+bool PuzzleParser::parse(std::string_view text) noexcept
+{
+    _pieces.clear();
+    _positions.clear();
+    _errors.clear();
+    _piece.clear();
+    _has_position = false;
+
+    size_t line_number = 0;
+
+    while (!text.empty()) {
+        size_t end = text.find('\n');
+        std::string_view line = text.substr(0, end);
+
+        _parse_line(trim(line), ++line_number);
+
+        if (end == std::string_view::npos)
+            break;
+
+        text.remove_prefix(end + 1);
+    }
+
+    _finish_piece();
+
+    if (_pieces.empty())
+        _error(line_number, "Puzzle contains no pieces");
+
+    return _errors.empty();
+}
+
+const std::vector<std::vector<utils::int3>>& PuzzleParser::get_pieces() const noexcept
+{
+    return _pieces;
+}
+
+const std::vector<utils::int3>& PuzzleParser::get_positions() const noexcept
+{
+    return _positions;
+}
+
+const std::vector<PuzzleParseError>& PuzzleParser::get_errors() const noexcept
+{
+    return _errors;
+}
+
+bool PuzzleParser::write(const std::filesystem::path& path, const std::vector<std::vector<utils::int3>>& pieces, const std::vector<utils::int3>& positions) noexcept
+{
+    std::string text;
+
+    for (size_t i = 0; i < pieces.size(); i++) {
+        if (i > 0)
+            text += '\n';
+
+        text += fmt::format("# {} {} {}\n", positions[i].x, positions[i].y, positions[i].z);
+
+        for (const auto& cube : pieces[i]) {
+            text += fmt::format("{} {} {}\n", cube.x, cube.y, cube.z);
+        }
+    }
+
+    std::ofstream stream(path, std::ios::binary);
+    stream.write(text.data(), static_cast<std::streamsize>(text.size()));
+
+    return static_cast<bool>(stream);
+}
+
+void PuzzleParser::_parse_line(std::string_view line, size_t line_number) noexcept
+{
+    if (line.empty()) {
+        _finish_piece();
+        return;
+    }
+
+    if (_piece.empty() && !_has_position)
+        _piece_line = line_number;
+
+    utils::int3 coordinates;
+
+    if (line.front() == '#') {
+        if (_has_position) {
+            _error(line_number, "Piece has more than one start position");
+            return;
+        }
+
+        if (_parse_coordinates(line.substr(1), coordinates, line_number)) {
+            _position = coordinates;
+            _has_position = true;
+        }
+
+        return;
+    }
+
+    if (_parse_coordinates(line, coordinates, line_number))
+        _piece.push_back(coordinates);
+}
+
+void PuzzleParser::_finish_piece() noexcept
+{
+    if (_piece.empty() && !_has_position)
+        return;
+
+    if (!_has_position) {
+        _error(_piece_line, "Piece has no start position");
+    } else if (_piece.empty()) {
+        _error(_piece_line, "Piece has no unit cubes");
+    } else if (_pieces.size() == max_pieces) {
+        _error(_piece_line, fmt::format("Puzzle has more than {} pieces", max_pieces));
+    } else {
+        // Sort in grid order and drop duplicated cubes
+        std::ranges::sort(_piece, {}, [](const utils::int3& v) { return std::tuple(v.z, v.y, v.x); });
+        _piece.erase(std::unique(_piece.begin(), _piece.end()), _piece.end());
+
+        for (const auto& cube : _piece) {
+            utils::int3 global = cube + _position;
+
+            if (global.x >= _dim || global.y >= _dim || global.z >= _dim) {
+                _error(_piece_line, fmt::format("Piece does not fit into a grid of size {} at its start position", _dim));
+                break;
+            }
+        }
+
+        _pieces.push_back(std::move(_piece));
+        _positions.push_back(_position);
+    }
+
+    _piece.clear();
+    _has_position = false;
+}
+
+bool PuzzleParser::_parse_coordinates(std::string_view text, utils::int3& coordinates, size_t line_number) noexcept
+{
+    const char* first = text.data();
+    const char* last = text.data() + text.size();
+
+    for (size_t axis = 0; axis < 3; axis++) {
+        while (first != last && is_blank(*first))
+            first++;
+
+        auto [end, error] = std::from_chars(first, last, coordinates[axis]);
+
+        if (error != std::errc() || (end != last && !is_blank(*end))) {
+            _error(line_number, fmt::format("Expected three integer coordinates, got \"{}\"", text));
+            return false;
+        }
+
+        if (coordinates[axis] < 0 || coordinates[axis] >= _dim) {
+            _error(line_number, fmt::format("Coordinate {} is outside of the grid [0, {})", coordinates[axis], _dim));
+            return false;
+        }
+
+        first = end;
+    }
+
+    while (first != last && is_blank(*first))
+        first++;
+
+    if (first != last) {
+        _error(line_number, fmt::format("Unexpected trailing input \"{}\"", std::string_view(first, last)));
+        return false;
+    }
+
+    return true;
+}
+
+void PuzzleParser::_error(size_t line_number, std::string message) noexcept
+{
+    _errors.push_back({line_number, std::move(message)});
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "utils.h"
+
+// Bound of the coordinates puzzle files may use, the solver grid is chosen afterwards
+inline constexpr int max_puzzle_coordinate = 1 << 16;
+
+struct PuzzleParseError
+{
+    size_t line;
+    std::string message;
+};
+
+// Parses the text puzzle format: one "x y z" unit cube per line, a "# x y z" start position per piece
+// and pieces separated by blank lines. Coordinates are validated against the grid dimension.
+class PuzzleParser final
+{
+public:
+    explicit PuzzleParser(int dim) noexcept;
+
+    [[nodiscard]] bool parse_file(const std::filesystem::path& path) noexcept;
+    [[nodiscard]] bool parse(std::string_view text) noexcept;
+
+    [[nodiscard]] const std::vector<std::vector<utils::int3>>& get_pieces() const noexcept;
+    [[nodiscard]] const std::vector<utils::int3>& get_positions() const noexcept;
+    [[nodiscard]] const std::vector<PuzzleParseError>& get_errors() const noexcept;
+
+    [[nodiscard]] static bool write(const std::filesystem::path& path, const std::vector<std::vector<utils::int3>>& pieces, const std::vector<utils::int3>& positions) noexcept;
+
+private:
+    void _parse_line(std::string_view line, size_t line_number) noexcept;
+    void _finish_piece() noexcept;
+    [[nodiscard]] bool _parse_coordinates(std::string_view text, utils::int3& coordinates, size_t line_number) noexcept;
+    void _error(size_t line_number, std::string message) noexcept;
+
+private:
+    int _dim;
+
+    std::vector<std::vector<utils::int3>> _pieces;
+    std::vector<utils::int3> _positions;
+    std::vector<PuzzleParseError> _errors;
+
+    std::vector<utils::int3> _piece;
+    utils::int3 _position = {0, 0, 0};
+    bool _has_position = false;
+    size_t _piece_line = 0;
+};
@@ -0,0 +1,177 @@
+#include "puzzle_solver.h"
+
+#include <algorithm>
+#include <fmt/format.h>
+
+#include "binary_puzzle.h"
+#include "burr_puzzle_wizard.h"
+
+namespace
+{
+    // Sizes are ascending, the first one that fits wins
+    template <size_t Index = 0>
+    std::unique_ptr<PuzzleSolver> create_dense_solver(size_t grid_size)
+    {
+        if constexpr (Index == supported_grid_sizes.size()) {
+            return nullptr;
+        } else {
+            if (grid_size <= supported_grid_sizes[Index])
+                return std::make_unique<BurrPuzzleWizard<supported_grid_sizes[Index]>>();
+
+            return create_dense_solver<Index + 1>(grid_size);
+        }
+    }
+
+    template <size_t Index = 0>
+    std::unique_ptr<PuzzleSolver> create_sparse_solver(size_t grid_size)
+    {
+        if constexpr (Index == supported_sparse_grid_sizes.size()) {
+            return nullptr;
+        } else {
+            if (grid_size <= supported_sparse_grid_sizes[Index])
+                return std::make_unique<BurrPuzzleWizard<supported_sparse_grid_sizes[Index], SparseOccupancy>>();
+
+            return create_sparse_solver<Index + 1>(grid_size);
+        }
+    }
+}
+
+bool parse_occupancy_backend(std::string_view text, OccupancyBackend& backend) noexcept
+{
+    for (OccupancyBackend candidate : {OccupancyBackend::Auto, OccupancyBackend::Dense, OccupancyBackend::Sparse}) {
+        if (text == to_string(candidate)) {
+            backend = candidate;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool parse_search_mode(std::string_view text, SearchMode& mode) noexcept
+{
+    for (SearchMode candidate : {SearchMode::Greedy, SearchMode::AStar, SearchMode::BreadthFirst}) {
+        if (text == to_string(candidate)) {
+            mode = candidate;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool parse_expansion_mode(std::string_view text, ExpansionMode& mode) noexcept
+{
+    for (ExpansionMode candidate : {ExpansionMode::Full, ExpansionMode::Partial}) {
+        if (text == to_string(candidate)) {
+            mode = candidate;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+int get_clearance(const std::vector<std::vector<utils::int3>>& pieces) noexcept
+{
+    int clearance = 0;
+
+    for (const auto& unit_cubes : pieces) {
+        if (unit_cubes.empty())
+            continue;
+
+        for (size_t axis = 0; axis < 3; axis++) {
+            const auto [min, max] = std::ranges::minmax(unit_cubes, {}, [axis](const utils::int3& cube) { return cube[axis]; });
+            clearance = std::max(clearance, max[axis] - min[axis] + 1);
+        }
+    }
+
+    return clearance;
+}
+
+size_t get_required_grid_size(const std::vector<std::vector<utils::int3>>& pieces, const std::vector<utils::int3>& positions) noexcept
+{
+    const int clearance = get_clearance(pieces);
+    int size = 0;
+
+    for (size_t i = 0; i < pieces.size(); i++) {
+        for (const auto& cube : pieces[i]) {
+            const utils::int3 global = cube + positions[i];
+            size = std::max({size, global.x + 1 + clearance, global.y + 1 + clearance, global.z + 1 + clearance});
+        }
+    }
+
+    return static_cast<size_t>(size);
+}
+
+std::unique_ptr<PuzzleSolver> create_puzzle_solver(size_t grid_size, OccupancyBackend backend) noexcept
+{
+    switch (backend) {
+        case OccupancyBackend::Auto: return grid_size <= supported_grid_sizes.back() ? create_dense_solver(grid_size) : create_sparse_solver(grid_size);
+        case OccupancyBackend::Dense: return create_dense_solver(grid_size);
+        case OccupancyBackend::Sparse: return create_sparse_solver(grid_size);
+    }
+
+    return nullptr;
+}
+
+bool read_puzzle(const std::filesystem::path& path, std::vector<std::vector<utils::int3>>& pieces, std::vector<utils::int3>& positions, std::vector<PuzzleParseError>& errors) noexcept
+{
+    pieces.clear();
+    positions.clear();
+
+    if (path.extension() == ".bpz") {
+        BinaryPuzzle binary;
+
+        if (!binary.open(path)) {
+            errors = {{0, binary.get_error()}};
+            return false;
+        }
+
+        for (size_t i = 0; i < binary.get_num_pieces(); i++) {
+            pieces.push_back(binary.get_unit_cube_positions(i));
+            positions.push_back(binary.get_position(i));
+        }
+    } else {
+        PuzzleParser parser(max_puzzle_coordinate);
+
+        if (!parser.parse_file(path)) {
+            errors = parser.get_errors();
+            return false;
+        }
+
+        pieces = parser.get_pieces();
+        positions = parser.get_positions();
+    }
+
+    errors.clear();
+
+    return true;
+}
+
+std::unique_ptr<PuzzleSolver> open_puzzle(const std::filesystem::path& path, std::vector<PuzzleParseError>& errors, OccupancyBackend backend) noexcept
+{
+    std::vector<std::vector<utils::int3>> pieces;
+    std::vector<utils::int3> positions;
+
+    if (!read_puzzle(path, pieces, positions, errors))
+        return nullptr;
+
+    const size_t grid_size = get_required_grid_size(pieces, positions);
+    std::unique_ptr<PuzzleSolver> solver = create_puzzle_solver(grid_size, backend);
+
+    if (!solver) {
+        const size_t largest = backend == OccupancyBackend::Dense ? supported_grid_sizes.back() : supported_sparse_grid_sizes.back();
+        errors = {{0, fmt::format("Puzzle needs a grid of size {}, the largest supported grid is {}", grid_size, largest)}};
+        return nullptr;
+    }
+
+    if (!solver->load_puzzle(pieces, positions)) {
+        errors = solver->get_load_errors();
+        return nullptr;
+    }
+
+    errors.clear();
+
+    return solver;
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <array>
+#include <filesystem>
+#include <memory>
+#include <string_view>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "puzzle_parser.h"
+#include "search_statistics.h"
+#include "solution_timeline.h"
+#include "solve_status.h"
+#include "utils.h"
+
+// How a solver stores occupied voxels. Auto picks dense row bitboards for grids they support and sparse bricks beyond.
+enum class OccupancyBackend {
+    Auto,
+    Dense,
+    Sparse
+};
+
+[[nodiscard]] constexpr std::string_view to_string(OccupancyBackend backend) noexcept
+{
+    switch (backend) {
+        case OccupancyBackend::Auto: return "auto";
+        case OccupancyBackend::Dense: return "dense";
+        case OccupancyBackend::Sparse: return "sparse";
+    }
+
+    return "unknown";
+}
+
+// Parses "auto", "dense" or "sparse"
+[[nodiscard]] bool parse_occupancy_backend(std::string_view text, OccupancyBackend& backend) noexcept;
+
+// Parses "greedy", "astar" or "bfs"
+[[nodiscard]] bool parse_search_mode(std::string_view text, SearchMode& mode) noexcept;
+
+// Parses "full" or "partial"
+[[nodiscard]] bool parse_expansion_mode(std::string_view text, ExpansionMode& mode) noexcept;
+
+// Grid size independent interface of BurrPuzzleWizard<N>, so the grid can be picked per puzzle at runtime
+class PuzzleSolver
+{
+public:
+    virtual ~PuzzleSolver() = default;
+
+    virtual bool read_puzzle_from_file(const std::filesystem::path& path) noexcept = 0;
+    virtual bool load_puzzle(const std::vector<std::vector<utils::int3>>& pieces, const std::vector<utils::int3>& positions) noexcept = 0;
+    virtual void init_field() noexcept = 0;
+    virtual void init_start_node() noexcept = 0;
+
+    virtual void move_piece(size_t index, utils::int3 direction) noexcept = 0;
+    virtual void set_positions(const std::vector<utils::int3>& positions) noexcept = 0;
+    [[nodiscard]] virtual const std::vector<utils::int3>& get_positions() const noexcept = 0;
+    [[nodiscard]] virtual const std::vector<utils::int3>& get_unit_cube_positions(size_t index) const noexcept = 0;
+    [[nodiscard]] virtual const std::vector<PuzzleParseError>& get_load_errors() const noexcept = 0;
+    [[nodiscard]] virtual const std::vector<utils::int3>& get_initial_positions() const noexcept = 0;
+    [[nodiscard]] virtual size_t get_dim() const noexcept = 0;
+    [[nodiscard]] virtual size_t get_volume() const noexcept = 0;
+    [[nodiscard]] virtual const glm::vec3& get_color(size_t index) const noexcept = 0;
+    [[nodiscard]] virtual size_t get_num_pieces() const noexcept = 0;
+    [[nodiscard]] virtual const std::vector<std::vector<size_t>>& get_identical_pieces() const noexcept = 0;
+    [[nodiscard]] virtual size_t get_num_symmetries() const noexcept = 0;
+    [[nodiscard]] virtual OccupancyBackend get_backend() const noexcept = 0;
+
+    virtual void set_limits(const SolverLimits& limits) noexcept = 0;
+    virtual void set_search_options(const SearchOptions& options) noexcept = 0;
+    virtual bool solve() noexcept = 0;
+
+    [[nodiscard]] virtual bool is_solved() const noexcept = 0;
+    [[nodiscard]] virtual double get_solve_time() const noexcept = 0;
+    [[nodiscard]] virtual int get_nodes_visited() const noexcept = 0;
+    [[nodiscard]] virtual SolveStatus get_status() const noexcept = 0;
+    [[nodiscard]] virtual size_t get_peak_memory_usage() const noexcept = 0;
+    [[nodiscard]] virtual const SolutionTimeline& get_solution() const noexcept = 0;
+
+    // Positions of every state on the path the search found, from the start to the disassembled state
+    [[nodiscard]] virtual const std::vector<std::vector<utils::int3>>& get_solution_path() const noexcept = 0;
+    [[nodiscard]] virtual SearchStatistics get_search_statistics() const = 0;
+    [[nodiscard]] virtual MemoryUsage get_memory_usage() const = 0;
+};
+
+// Grid sizes with a compiled dense solver. A row of the grid is one 64-bit word, the field holds N^2 rows.
+inline constexpr std::array<size_t, 6> supported_grid_sizes = {8, 16, 24, 32, 48, 64};
+
+// Grid sizes with a compiled sparse solver. Its cost follows the occupied voxels, so the grid can grow far
+// beyond the 64 columns of a dense row.
+inline constexpr std::array<size_t, 7> supported_sparse_grid_sizes = {16, 24, 32, 48, 64, 128, 256};
+
+// Room on every side of the assembly for the largest piece to slide out of it completely
+[[nodiscard]] int get_clearance(const std::vector<std::vector<utils::int3>>& pieces) noexcept;
+
+// Smallest grid holding the puzzle at its start positions plus the clearance beyond its far side
+[[nodiscard]] size_t get_required_grid_size(const std::vector<std::vector<utils::int3>>& pieces, const std::vector<utils::int3>& positions) noexcept;
+
+// Solver for the smallest supported grid of at least grid_size, nullptr if no supported grid is large enough
+[[nodiscard]] std::unique_ptr<PuzzleSolver> create_puzzle_solver(size_t grid_size, OccupancyBackend backend = OccupancyBackend::Auto) noexcept;
+
+// Reads the unit cubes and start positions of a .txt or .bpz puzzle
+[[nodiscard]] bool read_puzzle(const std::filesystem::path& path, std::vector<std::vector<utils::int3>>& pieces, std::vector<utils::int3>& positions,
+                               std::vector<PuzzleParseError>& errors) noexcept;
+
+// Reads a .txt or .bpz puzzle and loads it into a solver with the smallest grid that fits it
+[[nodiscard]] std::unique_ptr<PuzzleSolver> open_puzzle(const std::filesystem::path& path, std::vector<PuzzleParseError>& errors,
+                                                        OccupancyBackend backend = OccupancyBackend::Auto) noexcept;
@@ -0,0 +1,148 @@
+#include "row_kernels.h"
+
+#include <atomic>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define BPW_ROW_KERNELS_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// MSVC compiles intrinsics for any instruction set without flags, GCC and Clang need them enabled per function
+#if defined(BPW_ROW_KERNELS_X86) && (defined(__GNUC__) || defined(__clang__))
+#define BPW_TARGET(isa) __attribute__((target(isa)))
+#else
+#define BPW_TARGET(isa)
+#endif
+
+namespace
+{
+    bool overlaps_scalar(const uint64_t* field, const uint32_t* offsets, const uint64_t* bits, size_t count, uint32_t base, int shift) noexcept
+    {
+        if (shift >= 64)
+            return false;
+
+        uint64_t any = 0;
+
+        for (size_t i = 0; i < count; i++) {
+            any |= field[base + offsets[i]] & (bits[i] << shift);
+        }
+
+        return any != 0;
+    }
+
+#ifdef BPW_ROW_KERNELS_X86
+    // Shifts by 64 or more clear the lanes, so no special case is needed for pieces pushed past the last column
+    BPW_TARGET("avx2") bool overlaps_avx2(const uint64_t* field, const uint32_t* offsets, const uint64_t* bits, size_t count, uint32_t base, int shift) noexcept
+    {
+        const long long* rows = reinterpret_cast<const long long*>(field + base);
+        const __m128i shift_count = _mm_cvtsi32_si128(shift);
+        __m256i any = _mm256_setzero_si256();
+        size_t i = 0;
+
+        for (; i + 4 <= count; i += 4) {
+            const __m128i index = _mm_loadu_si128(reinterpret_cast<const __m128i*>(offsets + i));
+            const __m256i field_rows = _mm256_i32gather_epi64(rows, index, 8);
+            const __m256i piece_rows = _mm256_sll_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(bits + i)), shift_count);
+
+            any = _mm256_or_si256(any, _mm256_and_si256(field_rows, piece_rows));
+        }
+
+        if (!_mm256_testz_si256(any, any))
+            return true;
+
+        return overlaps_scalar(field, offsets + i, bits + i, count - i, base, shift);
+    }
+
+    BPW_TARGET("avx512f") bool overlaps_avx512(const uint64_t* field, const uint32_t* offsets, const uint64_t* bits, size_t count, uint32_t base, int shift) noexcept
+    {
+        const long long* rows = reinterpret_cast<const long long*>(field + base);
+        const __m128i shift_count = _mm_cvtsi32_si128(shift);
+        size_t i = 0;
+
+        for (; i + 8 <= count; i += 8) {
+            const __m256i index = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(offsets + i));
+            const __m512i field_rows = _mm512_i32gather_epi64(index, rows, 8);
+            const __m512i piece_rows = _mm512_sll_epi64(_mm512_loadu_si512(bits + i), shift_count);
+
+            if (_mm512_test_epi64_mask(field_rows, piece_rows))
+                return true;
+        }
+
+        return overlaps_scalar(field, offsets + i, bits + i, count - i, base, shift);
+    }
+
+    row_kernels::Isa detect_isa() noexcept
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_cpu_init();
+
+        if (__builtin_cpu_supports("avx512f"))
+            return row_kernels::Isa::Avx512;
+
+        if (__builtin_cpu_supports("avx2"))
+            return row_kernels::Isa::Avx2;
+#elif defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0);
+        const int max_leaf = info[0];
+
+        __cpuid(info, 1);
+        const bool os_saves_ymm = (info[2] & (1 << 27)) && (_xgetbv(0) & 0x6) == 0x6;
+
+        if (max_leaf >= 7 && os_saves_ymm) {
+            __cpuidex(info, 7, 0);
+
+            if ((info[1] & (1 << 16)) && (_xgetbv(0) & 0xe6) == 0xe6)
+                return row_kernels::Isa::Avx512;
+
+            if (info[1] & (1 << 5))
+                return row_kernels::Isa::Avx2;
+        }
+#endif
+
+        return row_kernels::Isa::Scalar;
+    }
+#else
+    row_kernels::Isa detect_isa() noexcept
+    {
+        return row_kernels::Isa::Scalar;
+    }
+#endif
+
+    std::atomic<row_kernels::Isa> selected_isa = row_kernels::get_supported_isa();
+}
+
+namespace row_kernels
+{
+    Isa get_supported_isa() noexcept
+    {
+        static const Isa isa = detect_isa();
+        return isa;
+    }
+
+    Isa get_isa() noexcept
+    {
+        return selected_isa.load(std::memory_order_relaxed);
+    }
+
+    void set_isa(Isa isa) noexcept
+    {
+        selected_isa.store(isa <= get_supported_isa() ? isa : get_supported_isa(), std::memory_order_relaxed);
+    }
+
+    bool overlaps(const uint64_t* field, const uint32_t* offsets, const uint64_t* bits, size_t count, uint32_t base, int shift) noexcept
+    {
+#ifdef BPW_ROW_KERNELS_X86
+        switch (selected_isa.load(std::memory_order_relaxed)) {
+            case Isa::Avx512: return overlaps_avx512(field, offsets, bits, count, base, shift);
+            case Isa::Avx2: return overlaps_avx2(field, offsets, bits, count, base, shift);
+            case Isa::Scalar: break;
+        }
+#endif
+
+        return overlaps_scalar(field, offsets, bits, count, base, shift);
+    }
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// Collision kernels on row bitboards: one 64-bit word per (y, z) row of voxels with bit x set for an
+// occupied voxel. A piece is tested against the field by shifting its rows by the x offset on the fly.
+namespace row_kernels
+{
+    enum class Isa {
+        Scalar,
+        Avx2,
+        Avx512
+    };
+
+    [[nodiscard]] constexpr std::string_view to_string(Isa isa) noexcept
+    {
+        switch (isa) {
+            case Isa::Scalar: return "scalar";
+            case Isa::Avx2: return "avx2";
+            case Isa::Avx512: return "avx512";
+        }
+
+        return "unknown";
+    }
+
+    // Best instruction set of the running CPU, detected once
+    [[nodiscard]] Isa get_supported_isa() noexcept;
+
+    // The kernels use the supported instruction set unless a lower one is forced, e.g. to compare them in a benchmark
+    [[nodiscard]] Isa get_isa() noexcept;
+    void set_isa(Isa isa) noexcept;
+
+    [[nodiscard]] constexpr uint64_t shift_row(uint64_t bits, int shift) noexcept
+    {
+        return shift < 64 ? bits << shift : 0;
+    }
+
+    // Whether field[base + offsets[i]] & (bits[i] << shift) is non-zero for any row i; a shift of 64 or more moves every bit out
+    [[nodiscard]] bool overlaps(const uint64_t* field, const uint32_t* offsets, const uint64_t* bits, size_t count, uint32_t base, int shift) noexcept;
+}
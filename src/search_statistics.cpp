@@ -0,0 +1,202 @@
+#include "search_statistics.h"
+
+#include <fmt/format.h>
+
+void Histogram::add(size_t value, uint64_t count) noexcept
+{
+    if (value >= _buckets.size())
+        _buckets.resize(value + 1, 0);
+
+    _buckets[value] += count;
+    _count += count;
+    _sum += value * count;
+}
+
+void Histogram::remove(size_t value, uint64_t count) noexcept
+{
+    if (value >= _buckets.size() || _buckets[value] < count)
+        return;
+
+    _buckets[value] -= count;
+    _count -= count;
+    _sum -= value * count;
+}
+
+void Histogram::clear() noexcept
+{
+    _buckets.clear();
+    _count = 0;
+    _sum = 0;
+}
+
+const std::vector<uint64_t>& Histogram::get_buckets() const noexcept
+{
+    return _buckets;
+}
+
+uint64_t Histogram::get_count() const noexcept
+{
+    return _count;
+}
+
+double Histogram::get_mean() const noexcept
+{
+    return _count > 0 ? static_cast<double>(_sum) / static_cast<double>(_count) : 0.0;
+}
+
+size_t Histogram::get_max() const noexcept
+{
+    for (size_t i = _buckets.size(); i > 0; i--) {
+        if (_buckets[i - 1] > 0)
+            return i - 1;
+    }
+
+    return 0;
+}
+
+std::string Histogram::to_json() const
+{
+    // Trailing empty buckets are dropped, e.g. when the open list drained the highest priorities
+    const size_t size = _count > 0 ? get_max() + 1 : 0;
+
+    return fmt::format(R"({{"count": {}, "mean": {:.4f}, "max": {}, "buckets": [{}]}})",
+                       _count, get_mean(), get_max(), fmt::join(_buckets.begin(), _buckets.begin() + static_cast<std::ptrdiff_t>(size), ", "));
+}
+
+void SearchStatistics::clear() noexcept
+{
+    *this = SearchStatistics();
+}
+
+void SearchStatistics::record_expansion(size_t num_neighbors, size_t frontier_size) noexcept
+{
+    _neighbors.add(num_neighbors);
+
+    if (_expansions++ % _frontier_sample_interval != 0)
+        return;
+
+    _frontier_sizes.push_back(frontier_size);
+
+    if (_frontier_sizes.size() < max_frontier_samples)
+        return;
+
+    for (size_t i = 0; i < _frontier_sizes.size() / 2; i++) {
+        _frontier_sizes[i] = _frontier_sizes[i * 2];
+    }
+
+    _frontier_sizes.resize(_frontier_sizes.size() / 2);
+    _frontier_sample_interval *= 2;
+}
+
+void SearchStatistics::record_reexpansion() noexcept
+{
+    _reexpansions++;
+}
+
+void SearchStatistics::record_reopen() noexcept
+{
+    _reopens++;
+}
+
+void SearchStatistics::record_component(size_t size) noexcept
+{
+    _component_sizes.add(size);
+}
+
+void SearchStatistics::record_slide(int distance) noexcept
+{
+    _slide_distances.add(static_cast<size_t>(distance));
+}
+
+void SearchStatistics::record_generated(bool duplicate) noexcept
+{
+    _generated++;
+
+    if (duplicate)
+        _duplicates++;
+}
+
+void SearchStatistics::record_push(int priority) noexcept
+{
+    _open_priorities.add(static_cast<size_t>(priority));
+}
+
+void SearchStatistics::record_pop(int priority) noexcept
+{
+    _open_priorities.remove(static_cast<size_t>(priority));
+}
+
+uint64_t SearchStatistics::get_expansions() const noexcept
+{
+    return _expansions;
+}
+
+uint64_t SearchStatistics::get_reexpansions() const noexcept
+{
+    return _reexpansions;
+}
+
+uint64_t SearchStatistics::get_reopens() const noexcept
+{
+    return _reopens;
+}
+
+uint64_t SearchStatistics::get_generated() const noexcept
+{
+    return _generated;
+}
+
+uint64_t SearchStatistics::get_duplicates() const noexcept
+{
+    return _duplicates;
+}
+
+double SearchStatistics::get_duplicate_rate() const noexcept
+{
+    return _generated > 0 ? static_cast<double>(_duplicates) / static_cast<double>(_generated) : 0.0;
+}
+
+double SearchStatistics::get_branching_factor() const noexcept
+{
+    return _neighbors.get_mean();
+}
+
+const Histogram& SearchStatistics::get_neighbors() const noexcept
+{
+    return _neighbors;
+}
+
+const Histogram& SearchStatistics::get_component_sizes() const noexcept
+{
+    return _component_sizes;
+}
+
+const Histogram& SearchStatistics::get_slide_distances() const noexcept
+{
+    return _slide_distances;
+}
+
+const Histogram& SearchStatistics::get_open_priorities() const noexcept
+{
+    return _open_priorities;
+}
+
+const std::vector<size_t>& SearchStatistics::get_frontier_sizes() const noexcept
+{
+    return _frontier_sizes;
+}
+
+uint64_t SearchStatistics::get_frontier_sample_interval() const noexcept
+{
+    return _frontier_sample_interval;
+}
+
+std::string SearchStatistics::to_json() const
+{
+    return fmt::format(R"({{"expansions": {}, "reexpansions": {}, "reopens": {}, "generated": {}, "duplicates": {}, "duplicate_rate": {:.4f}, "branching_factor": {:.4f}, )"
+                       R"("neighbors": {}, "component_sizes": {}, "slide_distances": {}, "open_priorities": {}, )"
+                       R"("frontier_sample_interval": {}, "frontier_sizes": [{}]}})",
+                       _expansions, _reexpansions, _reopens, _generated, _duplicates, get_duplicate_rate(), get_branching_factor(),
+                       _neighbors.to_json(), _component_sizes.to_json(), _slide_distances.to_json(), _open_priorities.to_json(),
+                       _frontier_sample_interval, fmt::join(_frontier_sizes, ", "));
+}
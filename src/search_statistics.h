@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Counts per integer value, buckets grow on demand
+class Histogram final
+{
+public:
+    void add(size_t value, uint64_t count = 1) noexcept;
+    void remove(size_t value, uint64_t count = 1) noexcept;
+    void clear() noexcept;
+
+    [[nodiscard]] const std::vector<uint64_t>& get_buckets() const noexcept;
+    [[nodiscard]] uint64_t get_count() const noexcept;
+    [[nodiscard]] double get_mean() const noexcept;
+    [[nodiscard]] size_t get_max() const noexcept;
+    [[nodiscard]] std::string to_json() const;
+
+private:
+    std::vector<uint64_t> _buckets;
+    uint64_t _count = 0;
+    uint64_t _sum = 0;
+};
+
+// Shape of a search, collected during BurrPuzzleWizard<N>::solve
+class SearchStatistics final
+{
+public:
+    static constexpr size_t max_frontier_samples = 1024;
+
+    void clear() noexcept;
+
+    void record_expansion(size_t num_neighbors, size_t frontier_size) noexcept;
+
+    // Partial expansion only, a state that is taken from the open list again for children it did not store yet
+    void record_reexpansion() noexcept;
+
+    // A* and breadth-first only, a stored state that was reached again with fewer moves before its expansion
+    void record_reopen() noexcept;
+    void record_component(size_t size) noexcept;
+    void record_slide(int distance) noexcept;
+    void record_generated(bool duplicate) noexcept;
+    void record_push(int priority) noexcept;
+    void record_pop(int priority) noexcept;
+
+    [[nodiscard]] uint64_t get_expansions() const noexcept;
+    [[nodiscard]] uint64_t get_reexpansions() const noexcept;
+    [[nodiscard]] uint64_t get_reopens() const noexcept;
+    [[nodiscard]] uint64_t get_generated() const noexcept;
+    [[nodiscard]] uint64_t get_duplicates() const noexcept;
+    [[nodiscard]] double get_duplicate_rate() const noexcept;
+    [[nodiscard]] double get_branching_factor() const noexcept;
+
+    [[nodiscard]] const Histogram& get_neighbors() const noexcept;
+    [[nodiscard]] const Histogram& get_component_sizes() const noexcept;
+    [[nodiscard]] const Histogram& get_slide_distances() const noexcept;
+    [[nodiscard]] const Histogram& get_open_priorities() const noexcept;
+
+    // One sample every get_frontier_sample_interval() expansions. The interval doubles whenever
+    // the samples fill up, so long searches keep their whole history at a coarser resolution.
+    [[nodiscard]] const std::vector<size_t>& get_frontier_sizes() const noexcept;
+    [[nodiscard]] uint64_t get_frontier_sample_interval() const noexcept;
+
+    [[nodiscard]] std::string to_json() const;
+
+private:
+    uint64_t _expansions = 0;
+    uint64_t _reexpansions = 0;
+    uint64_t _reopens = 0;
+    uint64_t _generated = 0;
+    uint64_t _duplicates = 0;
+
+    Histogram _neighbors;
+    Histogram _component_sizes;
+    Histogram _slide_distances;
+    Histogram _open_priorities;
+
+    std::vector<size_t> _frontier_sizes;
+    uint64_t _frontier_sample_interval = 1;
+};
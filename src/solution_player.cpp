@@ -0,0 +1,150 @@
+#include "solution_player.h"
+
+#include <algorithm>
+#include <cmath>
+
+void SolutionPlayer::load(SolutionTimeline timeline) noexcept
+{
+    _timeline = std::move(timeline);
+    _step_positions = _timeline.get_start_positions();
+    _offsets.resize(_step_positions.size());
+    _step = 0;
+    _time = 0.0f;
+    _playing = false;
+
+    _update_offsets();
+}
+
+void SolutionPlayer::clear() noexcept
+{
+    _timeline.clear();
+    _step_positions.clear();
+    _offsets.clear();
+    _step = 0;
+    _time = 0.0f;
+    _playing = false;
+}
+
+void SolutionPlayer::update(float delta_time) noexcept
+{
+    if (!_playing)
+        return;
+
+    seek(_time + delta_time * _speed);
+
+    if (_time >= static_cast<float>(_timeline.get_num_moves()))
+        _playing = false;
+}
+
+void SolutionPlayer::play() noexcept
+{
+    if (_time >= static_cast<float>(_timeline.get_num_moves()))
+        seek(0.0f);
+
+    _playing = true;
+}
+
+void SolutionPlayer::pause() noexcept
+{
+    _playing = false;
+}
+
+void SolutionPlayer::seek(float time) noexcept
+{
+    _time = std::clamp(time, 0.0f, static_cast<float>(_timeline.get_num_moves()));
+
+    _seek_step(static_cast<int>(std::floor(_time)));
+    _update_offsets();
+}
+
+void SolutionPlayer::set_speed(float moves_per_second) noexcept
+{
+    _speed = std::max(moves_per_second, 0.0f);
+}
+
+bool SolutionPlayer::is_loaded() const noexcept
+{
+    return !_timeline.empty();
+}
+
+bool SolutionPlayer::is_playing() const noexcept
+{
+    return _playing;
+}
+
+float SolutionPlayer::get_time() const noexcept
+{
+    return _time;
+}
+
+float SolutionPlayer::get_speed() const noexcept
+{
+    return _speed;
+}
+
+int SolutionPlayer::get_step() const noexcept
+{
+    return _step;
+}
+
+int SolutionPlayer::get_num_moves() const noexcept
+{
+    return _timeline.get_num_moves();
+}
+
+const std::vector<utils::int3>& SolutionPlayer::get_step_positions() const noexcept
+{
+    return _step_positions;
+}
+
+const std::vector<glm::vec3>& SolutionPlayer::get_piece_offsets() const noexcept
+{
+    return _offsets;
+}
+
+size_t SolutionPlayer::get_memory_usage() const noexcept
+{
+    return _timeline.get_memory_usage() + _step_positions.capacity() * sizeof(utils::int3) + _offsets.capacity() * sizeof(glm::vec3);
+}
+
+void SolutionPlayer::_seek_step(int step) noexcept
+{
+    step = std::clamp(step, 0, _timeline.get_num_moves());
+
+    if (std::abs(step - _step) >= SolutionTimeline::keyframe_interval) {
+        _timeline.get_positions(step, _step_positions);
+        _step = step;
+        return;
+    }
+
+    while (_step < step) {
+        _timeline.get_move(_step).apply(_step_positions);
+        _step++;
+    }
+
+    while (_step > step) {
+        _step--;
+        _timeline.get_move(_step).revert(_step_positions);
+    }
+}
+
+void SolutionPlayer::_update_offsets() noexcept
+{
+    for (size_t i = 0; i < _step_positions.size(); i++) {
+        _offsets[i] = static_cast<glm::vec3>(_step_positions[i]);
+    }
+
+    if (_step >= _timeline.get_num_moves())
+        return;
+
+    // Smoothstep easing so pieces accelerate out of and settle into each step
+    float t = _time - static_cast<float>(_step);
+    t = t * t * (3.0f - 2.0f * t);
+
+    const Move& move = _timeline.get_move(_step);
+
+    for (size_t i = 0; i < _offsets.size(); i++) {
+        if (move.contains(i))
+            _offsets[i][move.axis] += t * static_cast<float>(move.distance);
+    }
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "solution_timeline.h"
+#include "utils.h"
+
+// Animates a solved disassembly from its timeline. Only per-piece offsets are produced,
+// the solver field is never touched while playing or scrubbing.
+class SolutionPlayer final
+{
+public:
+    SolutionPlayer() = default;
+
+    void load(SolutionTimeline timeline) noexcept;
+    void clear() noexcept;
+
+    void update(float delta_time) noexcept;
+    void play() noexcept;
+    void pause() noexcept;
+    void seek(float time) noexcept;
+    void set_speed(float moves_per_second) noexcept;
+
+    [[nodiscard]] bool is_loaded() const noexcept;
+    [[nodiscard]] bool is_playing() const noexcept;
+    [[nodiscard]] float get_time() const noexcept;
+    [[nodiscard]] float get_speed() const noexcept;
+    [[nodiscard]] int get_step() const noexcept;
+    [[nodiscard]] int get_num_moves() const noexcept;
+    [[nodiscard]] const std::vector<utils::int3>& get_step_positions() const noexcept;
+    [[nodiscard]] const std::vector<glm::vec3>& get_piece_offsets() const noexcept;
+    [[nodiscard]] size_t get_memory_usage() const noexcept;
+
+private:
+    void _seek_step(int step) noexcept;
+    void _update_offsets() noexcept;
+
+private:
+    SolutionTimeline _timeline;
+
+    // Positions after `_step` moves, stepped incrementally while playing and restored from keyframes on far seeks
+    std::vector<utils::int3> _step_positions;
+    std::vector<glm::vec3> _offsets;
+
+    int _step = 0;
+    float _time = 0.0f;
+    float _speed = 2.0f;
+    bool _playing = false;
+};
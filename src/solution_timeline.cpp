@@ -0,0 +1,209 @@
+#include "solution_timeline.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+namespace
+{
+    constexpr char magic[4] = {'B', 'P', 'W', 'S'};
+    // Version 1 files could store a step that moved several components as one group, they are not read
+    constexpr uint32_t version = 2;
+
+    void write_varint(std::ofstream& stream, uint64_t value)
+    {
+        while (value >= 0x80) {
+            stream.put(static_cast<char>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+
+        stream.put(static_cast<char>(value));
+    }
+
+    bool read_varint(std::ifstream& stream, uint64_t& value)
+    {
+        value = 0;
+
+        for (int shift = 0; shift < 64; shift += 7) {
+            int byte = stream.get();
+
+            if (byte == EOF)
+                return false;
+
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+
+            if (!(byte & 0x80))
+                return true;
+        }
+
+        return false;
+    }
+
+    uint64_t zigzag_encode(int64_t value)
+    {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+
+    int64_t zigzag_decode(uint64_t value)
+    {
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+}
+
+SolutionTimeline::SolutionTimeline(std::vector<utils::int3> start_positions) noexcept
+    : _num_pieces(start_positions.size()), _start_positions(std::move(start_positions)), _end_positions(_start_positions)
+{
+    _push_keyframe();
+}
+
+void SolutionTimeline::push_move(const Move& move) noexcept
+{
+    _moves.push_back(move);
+    move.apply(_end_positions);
+
+    if (_moves.size() % keyframe_interval == 0)
+        _push_keyframe();
+}
+
+void SolutionTimeline::clear() noexcept
+{
+    _num_pieces = 0;
+    _moves.clear();
+    _start_positions.clear();
+    _end_positions.clear();
+    _keyframes.clear();
+}
+
+void SolutionTimeline::get_positions(int step, std::vector<utils::int3>& positions) const noexcept
+{
+    step = std::clamp(step, 0, get_num_moves());
+
+    const size_t keyframe = step / keyframe_interval;
+    const auto first = _keyframes.begin() + static_cast<std::ptrdiff_t>(keyframe * _num_pieces);
+
+    positions.assign(first, first + static_cast<std::ptrdiff_t>(_num_pieces));
+
+    for (int i = static_cast<int>(keyframe) * keyframe_interval; i < step; i++) {
+        _moves[i].apply(positions);
+    }
+}
+
+std::vector<utils::int3> SolutionTimeline::get_positions(int step) const noexcept
+{
+    std::vector<utils::int3> positions;
+    get_positions(step, positions);
+
+    return positions;
+}
+
+const std::vector<utils::int3>& SolutionTimeline::get_start_positions() const noexcept
+{
+    return _start_positions;
+}
+
+const Move& SolutionTimeline::get_move(int step) const noexcept
+{
+    return _moves[step];
+}
+
+int SolutionTimeline::get_num_moves() const noexcept
+{
+    return static_cast<int>(_moves.size());
+}
+
+size_t SolutionTimeline::get_num_pieces() const noexcept
+{
+    return _num_pieces;
+}
+
+bool SolutionTimeline::empty() const noexcept
+{
+    return _keyframes.empty();
+}
+
+size_t SolutionTimeline::get_memory_usage() const noexcept
+{
+    return _moves.capacity() * sizeof(Move) + (_keyframes.capacity() + _start_positions.capacity() + _end_positions.capacity()) * sizeof(utils::int3);
+}
+
+bool SolutionTimeline::save(const std::filesystem::path& path) const noexcept
+{
+    std::ofstream stream(path, std::ios::binary);
+
+    if (!stream.is_open() || empty())
+        return false;
+
+    stream.write(magic, sizeof(magic));
+    write_varint(stream, version);
+    write_varint(stream, _num_pieces);
+    write_varint(stream, _moves.size());
+
+    for (size_t i = 0; i < _num_pieces; i++) {
+        for (size_t axis = 0; axis < 3; axis++) {
+            write_varint(stream, zigzag_encode(_start_positions[i][axis]));
+        }
+    }
+
+    // Axis and distance share one varint, most moves fit into two or three bytes in total
+    for (const Move& move : _moves) {
+        write_varint(stream, move.group);
+        write_varint(stream, zigzag_encode(move.distance) * 3 + move.axis);
+    }
+
+    return stream.good();
+}
+
+bool SolutionTimeline::load(const std::filesystem::path& path) noexcept
+{
+    std::ifstream stream(path, std::ios::binary);
+
+    if (!stream.is_open())
+        return false;
+
+    char file_magic[4];
+    stream.read(file_magic, sizeof(file_magic));
+
+    uint64_t file_version, num_pieces, num_moves;
+
+    if (!stream || std::memcmp(file_magic, magic, sizeof(magic)) != 0)
+        return false;
+
+    if (!read_varint(stream, file_version) || file_version != version)
+        return false;
+
+    if (!read_varint(stream, num_pieces) || !read_varint(stream, num_moves) || num_pieces > 64)
+        return false;
+
+    std::vector<utils::int3> start_positions(num_pieces);
+
+    for (auto& position : start_positions) {
+        for (size_t axis = 0; axis < 3; axis++) {
+            uint64_t value;
+
+            if (!read_varint(stream, value))
+                return false;
+
+            position[axis] = static_cast<int>(zigzag_decode(value));
+        }
+    }
+
+    SolutionTimeline timeline(std::move(start_positions));
+
+    for (uint64_t i = 0; i < num_moves; i++) {
+        uint64_t group, axis_distance;
+
+        if (!read_varint(stream, group) || !read_varint(stream, axis_distance))
+            return false;
+
+        timeline.push_move({group, static_cast<int>(axis_distance % 3), static_cast<int>(zigzag_decode(axis_distance / 3))});
+    }
+
+    *this = std::move(timeline);
+
+    return true;
+}
+
+void SolutionTimeline::_push_keyframe() noexcept
+{
+    _keyframes.insert(_keyframes.end(), _end_positions.begin(), _end_positions.end());
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <filesystem>
+#include <vector>
+
+#include "move.h"
+#include "utils.h"
+
+// Disassembly stored as a move stream with absolute keyframes every `keyframe_interval` moves.
+// Any step is reconstructed from the closest preceding keyframe in at most keyframe_interval - 1 moves.
+class SolutionTimeline final
+{
+public:
+    static constexpr int keyframe_interval = 16;
+
+    SolutionTimeline() = default;
+    explicit SolutionTimeline(std::vector<utils::int3> start_positions) noexcept;
+
+    void push_move(const Move& move) noexcept;
+    void clear() noexcept;
+
+    void get_positions(int step, std::vector<utils::int3>& positions) const noexcept;
+    [[nodiscard]] std::vector<utils::int3> get_positions(int step) const noexcept;
+    [[nodiscard]] const std::vector<utils::int3>& get_start_positions() const noexcept;
+    [[nodiscard]] const Move& get_move(int step) const noexcept;
+    [[nodiscard]] int get_num_moves() const noexcept;
+    [[nodiscard]] size_t get_num_pieces() const noexcept;
+    [[nodiscard]] bool empty() const noexcept;
+    [[nodiscard]] size_t get_memory_usage() const noexcept;
+
+    // Only the start positions and the varint encoded move stream are written, keyframes are rebuilt on load
+    [[nodiscard]] bool save(const std::filesystem::path& path) const noexcept;
+    [[nodiscard]] bool load(const std::filesystem::path& path) noexcept;
+
+private:
+    void _push_keyframe() noexcept;
+
+private:
+    size_t _num_pieces = 0;
+
+    std::vector<Move> _moves;
+    std::vector<utils::int3> _start_positions;
+    std::vector<utils::int3> _end_positions;
+
+    // Keyframe k holds the absolute positions after k * keyframe_interval moves, flattened piece by piece
+    std::vector<utils::int3> _keyframes;
+};
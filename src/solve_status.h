@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+enum class SolveStatus {
+    NotStarted,
+    Solved,
+    Unsolvable,
+    TimeLimit,
+    MemoryLimit
+};
+
+// Zero disables a limit
+struct SolverLimits
+{
+    double max_time_ms = 0.0;
+    size_t max_memory_bytes = 0;
+};
+
+// Greedy takes the state closest to the border first and returns the first disassembly it finds. A* orders by
+// moves plus a lower bound on the moves left and breadth-first by moves alone, both return a disassembly with the
+// fewest moves; A* expands fewer states on the way.
+enum class SearchMode {
+    Greedy,
+    AStar,
+    BreadthFirst
+};
+
+// Full expansion stores every child of a state when it is expanded. Partial expansion stores only the children
+// with the priority the state was taken from the open list with and puts the state back with the best priority
+// of the rest, so children the search never reaches are not stored, at the cost of expanding states repeatedly.
+enum class ExpansionMode {
+    Full,
+    Partial
+};
+
+struct SearchOptions
+{
+    SearchMode mode = SearchMode::Greedy;
+    ExpansionMode expansion = ExpansionMode::Full;
+};
+
+// Bytes held by the search containers, counted incrementally while solving
+struct MemoryUsage
+{
+    size_t open_list = 0;
+    size_t closed_set = 0;
+    size_t state_arena = 0;
+    size_t blocking_graphs = 0;
+    size_t piece_cache = 0;
+    size_t stored_states = 0;
+    size_t peak_total = 0;
+
+    [[nodiscard]] constexpr size_t get_total() const noexcept
+    {
+        return open_list + closed_set + state_arena + blocking_graphs + piece_cache;
+    }
+
+    // Everything except the piece caches, which are bounded by the grid size instead of the state count
+    [[nodiscard]] constexpr double get_bytes_per_state() const noexcept
+    {
+        return stored_states > 0 ? static_cast<double>(open_list + closed_set + state_arena + blocking_graphs) / static_cast<double>(stored_states) : 0.0;
+    }
+};
+
+[[nodiscard]] constexpr std::string_view to_string(SolveStatus status) noexcept
+{
+    switch (status) {
+        case SolveStatus::NotStarted: return "not_started";
+        case SolveStatus::Solved: return "solved";
+        case SolveStatus::Unsolvable: return "unsolvable";
+        case SolveStatus::TimeLimit: return "time_limit";
+        case SolveStatus::MemoryLimit: return "memory_limit";
+    }
+
+    return "unknown";
+}
+
+[[nodiscard]] constexpr std::string_view to_string(SearchMode mode) noexcept
+{
+    switch (mode) {
+        case SearchMode::Greedy: return "greedy";
+        case SearchMode::AStar: return "astar";
+        case SearchMode::BreadthFirst: return "bfs";
+    }
+
+    return "unknown";
+}
+
+[[nodiscard]] constexpr std::string_view to_string(ExpansionMode mode) noexcept
+{
+    switch (mode) {
+        case ExpansionMode::Full: return "full";
+        case ExpansionMode::Partial: return "partial";
+    }
+
+    return "unknown";
+}
@@ -0,0 +1,190 @@
+#include "sparse_occupancy.h"
+
+#include <algorithm>
+#include <limits>
+#include <map>
+
+namespace
+{
+    size_t get_alignment(utils::int3 position) noexcept
+    {
+        return static_cast<size_t>((position.x & 3) + 4 * (position.y & 3) + 16 * (position.z & 3));
+    }
+
+    // First brick at or after `first` with a key of at least `key`
+    size_t find_brick(const std::vector<sparse::Brick>& bricks, size_t first, uint64_t key) noexcept
+    {
+        return static_cast<size_t>(std::lower_bound(bricks.begin() + static_cast<std::ptrdiff_t>(first), bricks.end(), key,
+                                                    [](const sparse::Brick& brick, uint64_t value) { return brick.key < value; }) - bricks.begin());
+    }
+}
+
+SparsePiece::SparsePiece(std::vector<utils::int3> unit_cubes) noexcept
+    : _positions(std::move(unit_cubes))
+{
+    for (size_t alignment = 0; alignment < _bricks.size(); alignment++) {
+        const utils::int3 shift = {static_cast<int>(alignment % 4), static_cast<int>(alignment / 4 % 4), static_cast<int>(alignment / 16)};
+        std::map<uint64_t, uint64_t> bricks;
+        sparse::BrickBounds& bounds = _bounds[alignment];
+
+        bounds = {{std::numeric_limits<int>::max(), std::numeric_limits<int>::max(), std::numeric_limits<int>::max()}, {-1, -1, -1}};
+
+        for (const auto& cube : _positions) {
+            const utils::int3 voxel = cube + shift;
+            const utils::int3 brick = {voxel.x / sparse::brick_size, voxel.y / sparse::brick_size, voxel.z / sparse::brick_size};
+
+            bricks[sparse::pack_key(brick)] |= uint64_t(1) << get_alignment(voxel);
+
+            for (size_t axis = 0; axis < 3; axis++) {
+                bounds.min[axis] = std::min(bounds.min[axis], brick[axis]);
+                bounds.max[axis] = std::max(bounds.max[axis], brick[axis]);
+            }
+        }
+
+        for (const auto& [key, bits] : bricks) {
+            _bricks[alignment].push_back({key, bits});
+        }
+    }
+}
+
+bool SparsePiece::overlaps(utils::int3 position, const SparsePiece& other, utils::int3 other_position) const noexcept
+{
+    const sparse::BrickBounds& bounds = _bounds[get_alignment(position)];
+    const sparse::BrickBounds& other_bounds = other._bounds[get_alignment(other_position)];
+
+    // Pieces whose brick ranges are disjoint on one axis cannot share a voxel
+    for (size_t axis = 0; axis < 3; axis++) {
+        const int shift = position[axis] / sparse::brick_size;
+        const int other_shift = other_position[axis] / sparse::brick_size;
+
+        if (bounds.max[axis] + shift < other_bounds.min[axis] + other_shift || other_bounds.max[axis] + other_shift < bounds.min[axis] + shift)
+            return false;
+    }
+
+    const auto& bricks = get_bricks(position);
+    const auto& other_bricks = other.get_bricks(other_position);
+    const uint64_t offset = get_brick_offset(position);
+    const uint64_t other_offset = get_brick_offset(other_position);
+
+    size_t i = 0;
+    size_t j = 0;
+
+    while (i < bricks.size() && j < other_bricks.size()) {
+        const uint64_t key = bricks[i].key + offset;
+        const uint64_t other_key = other_bricks[j].key + other_offset;
+
+        if (key < other_key) {
+            i++;
+        } else if (other_key < key) {
+            j++;
+        } else {
+            if (bricks[i].bits & other_bricks[j].bits)
+                return true;
+
+            i++;
+            j++;
+        }
+    }
+
+    return false;
+}
+
+size_t SparsePiece::get_num_unit_cubes() const noexcept
+{
+    return _positions.size();
+}
+
+const std::vector<utils::int3>& SparsePiece::get_unit_cube_positions() const noexcept
+{
+    return _positions;
+}
+
+size_t SparsePiece::get_cache_memory_usage() const noexcept
+{
+    size_t bytes = 0;
+
+    for (const auto& bricks : _bricks) {
+        bytes += bricks.capacity() * sizeof(sparse::Brick) + utils::allocation_overhead;
+    }
+
+    return bytes;
+}
+
+const std::vector<sparse::Brick>& SparsePiece::get_bricks(utils::int3 position) const noexcept
+{
+    return _bricks[get_alignment(position)];
+}
+
+uint64_t SparsePiece::get_brick_offset(utils::int3 position) noexcept
+{
+    return sparse::pack_key({position.x / sparse::brick_size, position.y / sparse::brick_size, position.z / sparse::brick_size});
+}
+
+void SparseField::clear() noexcept
+{
+    _bricks.clear();
+    _coarse = {};
+}
+
+void SparseField::add(const SparsePiece& piece, utils::int3 position) noexcept
+{
+    const uint64_t offset = SparsePiece::get_brick_offset(position);
+    size_t cursor = 0;
+
+    for (const auto& brick : piece.get_bricks(position)) {
+        const uint64_t key = brick.key + offset;
+        cursor = find_brick(_bricks, cursor, key);
+
+        if (cursor < _bricks.size() && _bricks[cursor].key == key) {
+            _bricks[cursor].bits |= brick.bits;
+        } else {
+            _bricks.insert(_bricks.begin() + static_cast<std::ptrdiff_t>(cursor), {key, brick.bits});
+
+            const size_t coarse = sparse::get_coarse_index(key);
+            _coarse[coarse / 64] |= uint64_t(1) << (coarse % 64);
+        }
+
+        cursor++;
+    }
+}
+
+void SparseField::remove(const SparsePiece& piece, utils::int3 position) noexcept
+{
+    const uint64_t offset = SparsePiece::get_brick_offset(position);
+    size_t cursor = 0;
+
+    for (const auto& brick : piece.get_bricks(position)) {
+        const uint64_t key = brick.key + offset;
+        cursor = find_brick(_bricks, cursor, key);
+
+        if (cursor == _bricks.size())
+            return;
+
+        if (_bricks[cursor].key == key)
+            _bricks[cursor].bits &= ~brick.bits;
+    }
+}
+
+bool SparseField::overlaps(const SparsePiece& piece, utils::int3 position) const noexcept
+{
+    const uint64_t offset = SparsePiece::get_brick_offset(position);
+    size_t cursor = 0;
+
+    for (const auto& brick : piece.get_bricks(position)) {
+        const uint64_t key = brick.key + offset;
+        const size_t coarse = sparse::get_coarse_index(key);
+
+        if (!(_coarse[coarse / 64] >> (coarse % 64) & 1))
+            continue;
+
+        cursor = find_brick(_bricks, cursor, key);
+
+        if (cursor == _bricks.size())
+            return false;
+
+        if (_bricks[cursor].key == key && (_bricks[cursor].bits & brick.bits))
+            return true;
+    }
+
+    return false;
+}
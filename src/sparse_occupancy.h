@@ -0,0 +1,95 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "utils.h"
+
+namespace sparse
+{
+    // 4x4x4 voxels in one word, bit x + 4 * y + 16 * z
+    struct Brick
+    {
+        // Brick coordinates packed as z << 32 | y << 16 | x, so sorting by key is grid order and a
+        // translation by whole bricks is an addition that keeps the order
+        uint64_t key;
+        uint64_t bits;
+    };
+
+    inline constexpr int brick_size = 4;
+
+    [[nodiscard]] constexpr uint64_t pack_key(utils::int3 brick) noexcept
+    {
+        return static_cast<uint64_t>(brick.z) << 32 | static_cast<uint64_t>(brick.y) << 16 | static_cast<uint64_t>(brick.x);
+    }
+
+    // Coarse level of a field: one bit per brick of a 16x16x16 brick window, covering a 64 grid exactly.
+    // Larger grids wrap around, a set bit then only means that one of the aliased bricks may be occupied.
+    // Most of a large grid is empty, so the aliased bits still reject about half of the tested bricks there.
+    inline constexpr size_t coarse_size = 16;
+
+    using CoarseMask = std::array<uint64_t, coarse_size * coarse_size * coarse_size / 64>;
+
+    [[nodiscard]] constexpr size_t get_coarse_index(uint64_t key) noexcept
+    {
+        return (key & (coarse_size - 1)) | (key >> 16 & (coarse_size - 1)) << 4 | (key >> 32 & (coarse_size - 1)) << 8;
+    }
+
+    // Inclusive range of brick coordinates
+    struct BrickBounds
+    {
+        utils::int3 min;
+        utils::int3 max;
+    };
+}
+
+// Piece stored as the occupied bricks only. The brick lists for all 64 alignments of a position
+// inside a brick are built up front, so placing the piece anywhere only offsets the keys.
+class SparsePiece final
+{
+public:
+    SparsePiece(std::vector<utils::int3> unit_cubes) noexcept;
+
+    [[nodiscard]] bool overlaps(utils::int3 position, const SparsePiece& other, utils::int3 other_position) const noexcept;
+
+    [[nodiscard]] size_t get_num_unit_cubes() const noexcept;
+    [[nodiscard]] const std::vector<utils::int3>& get_unit_cube_positions() const noexcept;
+    [[nodiscard]] size_t get_cache_memory_usage() const noexcept;
+
+    // Bricks of the piece at a position, sorted by key; the keys still miss the whole brick offset
+    // returned by get_brick_offset
+    [[nodiscard]] const std::vector<sparse::Brick>& get_bricks(utils::int3 position) const noexcept;
+    [[nodiscard]] static uint64_t get_brick_offset(utils::int3 position) noexcept;
+
+private:
+    std::array<std::vector<sparse::Brick>, 64> _bricks;
+    std::array<sparse::BrickBounds, 64> _bounds;
+    std::vector<utils::int3> _positions;
+};
+
+// Occupancy of a grid as a sorted list of non-empty bricks. Memory and the cost of a collision
+// test grow with the occupied volume instead of the grid volume. A coarse mask of the bricks in the
+// list is tested first, so bricks of a piece that land in empty space skip the search in the list.
+// The dense field has no coarse level, its rows are already a bitmap read without any search.
+class SparseField final
+{
+public:
+    void clear() noexcept;
+    void add(const SparsePiece& piece, utils::int3 position) noexcept;
+
+    // Emptied bricks stay in the list, so moving a piece back and forth does not reallocate
+    void remove(const SparsePiece& piece, utils::int3 position) noexcept;
+
+    [[nodiscard]] bool overlaps(const SparsePiece& piece, utils::int3 position) const noexcept;
+
+private:
+    std::vector<sparse::Brick> _bricks;
+    sparse::CoarseMask _coarse = {};
+};
+
+struct SparseOccupancy
+{
+    using Piece = SparsePiece;
+    using Field = SparseField;
+};
@@ -47,6 +47,18 @@ namespace utils
 
             throw std::runtime_error("utils::int3: Index out of range.");
         }
+
+        const int& operator[](size_t index) const
+        {
+            if (index == 0)
+                return x;
+            if (index == 1)
+                return y;
+            if (index == 2)
+                return z;
+
+            throw std::runtime_error("utils::int3: Index out of range.");
+        }
         
         operator glm::vec3() const
         {
@@ -72,4 +84,7 @@ namespace utils
     {
         return vec.x + vec.y * dim + vec.z * dim * dim;
     }
+
+    // Bookkeeping bytes the allocator adds to every heap block, used for memory accounting
+    inline constexpr size_t allocation_overhead = 16;
 }
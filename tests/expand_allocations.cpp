@@ -0,0 +1,87 @@
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <fmt/core.h>
+
+#include "bench_support.h"
+#include "burr_puzzle_wizard.h"
+#include "solver_kernels.h"
+
+// Expands states recorded from a real solve through the private search primitives
+namespace
+{
+    // Number of allocations made by one pass of expansions over every recorded state, children are derived from their parent
+    template <size_t N, typename Occupancy>
+    [[nodiscard]] uint64_t expand_all(BurrPuzzleWizardKernels<N, Occupancy>& kernels, const RecordedStates& recorded)
+    {
+        const auto& states = recorded.states;
+        uint64_t allocations = 0;
+
+        for (size_t state = 0; state < states.size(); state++) {
+            const size_t parent = recorded.parents[state];
+            kernels.build_field(states[state]);
+
+            const uint64_t start = get_allocation_count();
+
+            if (parent == state)
+                (void)kernels.expand(states[state]);
+            else
+                (void)kernels.expand(states[state], &states[parent], &recorded.parent_graphs[parent]);
+
+            allocations += get_allocation_count() - start;
+        }
+
+        return allocations;
+    }
+
+    template <size_t N, typename Occupancy = DenseOccupancy<N>>
+    [[nodiscard]] bool check_puzzle(const std::filesystem::path& path)
+    {
+        const std::string puzzle = path.stem().string();
+        auto wizard = std::make_unique<BurrPuzzleWizard<N, Occupancy>>();
+        const std::string_view backend = to_string(wizard->get_backend());
+
+        if (!wizard->read_puzzle_from_file(path)) {
+            fmt::println(stderr, "{} {} {}: {}", puzzle, N, backend, wizard->get_load_errors().front().message);
+            return false;
+        }
+
+        wizard->init_field();
+        wizard->init_start_node();
+
+        if (!wizard->solve()) {
+            fmt::println(stderr, "{} {} {}: not solvable at this grid size", puzzle, N, backend);
+            return false;
+        }
+
+        BurrPuzzleWizardKernels<N, Occupancy> kernels(*wizard);
+        const RecordedStates recorded = record_states(*wizard, kernels);
+
+        // The first pass grows the scratch buffers, after that an expansion must not allocate
+        (void)expand_all(kernels, recorded);
+        const uint64_t allocations = expand_all(kernels, recorded);
+
+        fmt::println("{:<12} {:>4} {:<7} {:>6} states {:>6} allocations", puzzle, N, backend, recorded.states.size(), allocations);
+
+        return allocations == 0;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const std::filesystem::path puzzles = argc > 1 ? argv[1] : "res/puzzles";
+
+    bool passed = true;
+
+    for (const char* name : {"Puzzle6.txt", "Puzzle18_Simple.txt", "Puzzle18.txt"}) {
+        const std::filesystem::path path = puzzles / name;
+
+        passed &= check_puzzle<48>(path);
+        passed &= check_puzzle<64>(path);
+        passed &= check_puzzle<64, SparseOccupancy>(path);
+    }
+
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,65 @@
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+#include <fmt/core.h>
+
+#include "puzzle_solver.h"
+
+// A* has to find solutions as short as the ones of a breadth first search, which only holds while its bound on the
+// moves left never overestimates
+namespace
+{
+    [[nodiscard]] std::optional<int> solve(const std::filesystem::path& path, OccupancyBackend backend, SearchOptions search)
+    {
+        std::vector<PuzzleParseError> errors;
+        std::unique_ptr<PuzzleSolver> wizard = open_puzzle(path, errors, backend);
+
+        if (!wizard) {
+            fmt::println(stderr, "{}: could not be read", path.stem().string());
+            return std::nullopt;
+        }
+
+        wizard->init_field();
+        wizard->init_start_node();
+        wizard->set_search_options(search);
+
+        if (!wizard->solve()) {
+            fmt::println(stderr, "{} {} {}: not solved", path.stem().string(), to_string(wizard->get_backend()), to_string(search.mode));
+            return std::nullopt;
+        }
+
+        return wizard->get_solution().get_num_moves();
+    }
+
+    [[nodiscard]] bool check_puzzle(const std::filesystem::path& path, OccupancyBackend backend)
+    {
+        const std::optional<int> shortest = solve(path, backend, {SearchMode::BreadthFirst, ExpansionMode::Full});
+        const std::optional<int> full = solve(path, backend, {SearchMode::AStar, ExpansionMode::Full});
+        const std::optional<int> partial = solve(path, backend, {SearchMode::AStar, ExpansionMode::Partial});
+
+        if (!shortest || !full || !partial)
+            return false;
+
+        fmt::println("{:<18} {:<7} bfs {:>4} moves astar {:>4} moves astar/partial {:>4} moves", path.stem().string(), to_string(backend), *shortest, *full, *partial);
+
+        return *full == *shortest && *partial == *shortest;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const std::filesystem::path puzzles = argc > 1 ? argv[1] : "res/puzzles";
+
+    bool passed = true;
+
+    // Breadth first searches of the larger puzzles take too long for a test
+    for (const char* name : {"Puzzle6_Empty.txt", "Puzzle6_Template.txt", "Puzzle6.txt"}) {
+        for (OccupancyBackend backend : {OccupancyBackend::Dense, OccupancyBackend::Sparse}) {
+            passed &= check_puzzle(puzzles / name, backend);
+        }
+    }
+
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,87 @@
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+#include <fmt/core.h>
+
+#include "puzzle_solver.h"
+
+// Replays the solution timeline of every puzzle, directly and after a save and load, and compares each step with
+// the states on the solver's path
+namespace
+{
+    [[nodiscard]] bool check_puzzle(const std::filesystem::path& path, OccupancyBackend backend, SearchOptions search)
+    {
+        const std::string puzzle = path.stem().string();
+        std::vector<PuzzleParseError> errors;
+        std::unique_ptr<PuzzleSolver> wizard = open_puzzle(path, errors, backend);
+
+        if (!wizard) {
+            fmt::println(stderr, "{}: could not be read", puzzle);
+            return false;
+        }
+
+        wizard->init_field();
+        wizard->init_start_node();
+        wizard->set_search_options(search);
+
+        if (!wizard->solve()) {
+            fmt::println(stderr, "{} {} {}: not solved", puzzle, to_string(wizard->get_backend()), to_string(search.mode));
+            return false;
+        }
+
+        const SolutionTimeline& solution = wizard->get_solution();
+        const auto& solution_path = wizard->get_solution_path();
+        size_t mismatches = 0;
+
+        if (static_cast<size_t>(solution.get_num_moves()) + 1 != solution_path.size()) {
+            fmt::println(stderr, "{}: {} moves for a path of {} states", puzzle, solution.get_num_moves(), solution_path.size());
+            return false;
+        }
+
+        // The saved solution has to load back into the same steps
+        const std::filesystem::path saved = std::filesystem::temp_directory_path() / fmt::format("burr_solution_replay_{}.solution", puzzle);
+        SolutionTimeline loaded;
+
+        if (!solution.save(saved) || !loaded.load(saved) || loaded.get_num_moves() != solution.get_num_moves()) {
+            fmt::println(stderr, "{}: the solution does not survive a save and load", puzzle);
+            return false;
+        }
+
+        std::filesystem::remove(saved);
+
+        for (int step = 0; step <= solution.get_num_moves(); step++) {
+            const auto& positions = solution_path[static_cast<size_t>(step)];
+
+            if (solution.get_positions(step) != positions || loaded.get_positions(step) != positions)
+                mismatches++;
+        }
+
+        fmt::println("{:<18} {:<7} {:<7} {:<8} {:>4} moves {:>4} mismatches", puzzle, to_string(wizard->get_backend()), to_string(search.mode), to_string(search.expansion), solution.get_num_moves(),
+                     mismatches);
+
+        return mismatches == 0;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const std::filesystem::path puzzles = argc > 1 ? argv[1] : "res/puzzles";
+
+    bool passed = true;
+
+    for (const char* name : {"Puzzle6_Empty.txt", "Puzzle6_Template.txt", "Puzzle6.txt", "Puzzle18_Simple.txt", "Puzzle18_Half.txt", "Puzzle18_Template.txt", "Puzzle18.txt"}) {
+        for (OccupancyBackend backend : {OccupancyBackend::Dense, OccupancyBackend::Sparse}) {
+            passed &= check_puzzle(puzzles / name, backend, {SearchMode::Greedy, ExpansionMode::Full});
+            passed &= check_puzzle(puzzles / name, backend, {SearchMode::Greedy, ExpansionMode::Partial});
+        }
+    }
+
+    // Shortest searches reopen states with the positions of the better path
+    for (const char* name : {"Puzzle6_Empty.txt", "Puzzle6_Template.txt", "Puzzle6.txt"}) {
+        passed &= check_puzzle(puzzles / name, OccupancyBackend::Dense, {SearchMode::AStar, ExpansionMode::Full});
+        passed &= check_puzzle(puzzles / name, OccupancyBackend::Dense, {SearchMode::BreadthFirst, ExpansionMode::Partial});
+    }
+
+    return passed ? 0 : 1;
+}
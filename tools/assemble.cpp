@@ -0,0 +1,317 @@
+#include <algorithm>
+#include <charconv>
+#include <climits>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <fmt/core.h>
+
+#include "assembler.h"
+#include "node.h"
+#include "puzzle_parser.h"
+#include "puzzle_solver.h"
+
+// Finds the assemblies of the pieces of a puzzle file. The target shape is the assembled puzzle itself unless
+// --target names a puzzle file whose pieces together form the shape. Every assembly can be written as a
+// puzzle file, with the pieces at their assembled positions, and opened or solved like any other puzzle.
+// With --solve every assembly is handed to a pool of solvers as soon as it is found and one JSON line per
+// assembly is printed as its solve finishes.
+namespace
+{
+    struct Options
+    {
+        std::filesystem::path input;
+        std::filesystem::path target;
+        std::filesystem::path output;
+        size_t max_assemblies = 0;
+        size_t threads = 1;
+        bool progress = false;
+        bool solve = false;
+        size_t solve_threads = std::max(1u, std::thread::hardware_concurrency());
+        SolverLimits limits;
+    };
+
+    struct SolveJob
+    {
+        size_t index;
+        Assembly assembly;
+    };
+
+    // Blocks the assembler while the solvers are behind, so at most `capacity` assemblies wait in memory
+    class BoundedQueue final
+    {
+    public:
+        explicit BoundedQueue(size_t capacity) noexcept : _capacity(capacity) {}
+
+        void push(SolveJob job) noexcept
+        {
+            std::unique_lock lock(_mutex);
+            _not_full.wait(lock, [&] { return _jobs.size() < _capacity; });
+            _jobs.push_back(std::move(job));
+            _not_empty.notify_one();
+        }
+
+        // Returns nothing once the queue is closed and drained
+        std::optional<SolveJob> pop() noexcept
+        {
+            std::unique_lock lock(_mutex);
+            _not_empty.wait(lock, [&] { return !_jobs.empty() || _closed; });
+
+            if (_jobs.empty())
+                return std::nullopt;
+
+            SolveJob job = std::move(_jobs.front());
+            _jobs.pop_front();
+            _not_full.notify_one();
+
+            return job;
+        }
+
+        void close() noexcept
+        {
+            std::scoped_lock lock(_mutex);
+            _closed = true;
+            _not_empty.notify_all();
+        }
+
+    private:
+        size_t _capacity;
+        std::deque<SolveJob> _jobs;
+        bool _closed = false;
+        std::mutex _mutex;
+        std::condition_variable _not_full;
+        std::condition_variable _not_empty;
+    };
+
+    template <typename T>
+    bool parse_number(std::string_view text, T& value)
+    {
+        auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+        return error == std::errc() && end == text.data() + text.size();
+    }
+
+    bool parse_options(int argc, char** argv, Options& options)
+    {
+        for (int i = 1; i < argc; i++) {
+            std::string_view argument = argv[i];
+
+            if (argument.starts_with("--") && argument != "--progress" && argument != "--solve" && i + 1 == argc)
+                return false;
+
+            if (argument == "--target") {
+                options.target = argv[++i];
+            } else if (argument == "--output") {
+                options.output = argv[++i];
+            } else if (argument == "--max") {
+                if (!parse_number(argv[++i], options.max_assemblies))
+                    return false;
+            } else if (argument == "--threads") {
+                if (!parse_number(argv[++i], options.threads) || options.threads == 0)
+                    return false;
+            } else if (argument == "--progress") {
+                options.progress = true;
+            } else if (argument == "--solve") {
+                options.solve = true;
+            } else if (argument == "--solve-threads") {
+                if (!parse_number(argv[++i], options.solve_threads) || options.solve_threads == 0)
+                    return false;
+            } else if (argument == "--time-limit") {
+                if (!parse_number(argv[++i], options.limits.max_time_ms))
+                    return false;
+            } else if (argument == "--memory-limit") {
+                size_t megabytes;
+
+                if (!parse_number(argv[++i], megabytes))
+                    return false;
+
+                options.limits.max_memory_bytes = megabytes << 20;
+            } else if (options.input.empty()) {
+                options.input = argument;
+            } else {
+                return false;
+            }
+        }
+
+        return !options.input.empty();
+    }
+
+    bool parse_puzzle(const std::filesystem::path& path, PuzzleParser& parser)
+    {
+        if (parser.parse_file(path))
+            return true;
+
+        for (const auto& error : parser.get_errors()) {
+            fmt::println("{}:{}: {}", path.string(), error.line, error.message);
+        }
+
+        return false;
+    }
+
+    // Assemblies sit where the target is, the solver needs room around the pieces to slide them out
+    void move_to_clearance(Assembly& assembly)
+    {
+        const int clearance = get_clearance(assembly.pieces);
+        utils::int3 min = {INT_MAX, INT_MAX, INT_MAX};
+
+        for (size_t i = 0; i < assembly.pieces.size(); i++) {
+            for (const auto& cube : assembly.pieces[i]) {
+                for (size_t axis = 0; axis < 3; axis++) {
+                    min[axis] = std::min(min[axis], cube[axis] + assembly.positions[i][axis]);
+                }
+            }
+        }
+
+        for (auto& position : assembly.positions) {
+            for (size_t axis = 0; axis < 3; axis++) {
+                position[axis] += clearance - min[axis];
+            }
+        }
+    }
+
+    // Moves along the solver's path until a piece first counts as free, i.e. has left the assembly
+    int get_moves_to_first_removal(const std::vector<std::vector<utils::int3>>& path, size_t grid_size)
+    {
+        const int dim = static_cast<int>(grid_size);
+
+        for (size_t step = 1; step < path.size(); step++) {
+            if (Node::count_free_pieces(path[step], dim) > Node::count_free_pieces(path.front(), dim))
+                return static_cast<int>(step);
+        }
+
+        return 0;
+    }
+
+    std::string solve_assembly(SolveJob& job, const SolverLimits& limits)
+    {
+        move_to_clearance(job.assembly);
+
+        std::unique_ptr<PuzzleSolver> wizard = create_puzzle_solver(get_required_grid_size(job.assembly.pieces, job.assembly.positions));
+
+        if (!wizard || !wizard->load_puzzle(job.assembly.pieces, job.assembly.positions))
+            return fmt::format(R"({{"assembly":{},"status":"load_error"}})", job.index);
+
+        wizard->init_field();
+        wizard->init_start_node();
+        wizard->set_limits(limits);
+        wizard->solve();
+
+        const SolutionTimeline& solution = wizard->get_solution();
+        const bool solved = wizard->get_status() == SolveStatus::Solved;
+
+        return fmt::format(R"({{"assembly":{},"status":"{}","moves":{},"first_removal":{},"nodes":{},"ms":{:.3f},"peak_memory":{}}})",
+                           job.index, to_string(wizard->get_status()), solved ? solution.get_num_moves() : 0, solved ? get_moves_to_first_removal(wizard->get_solution_path(), wizard->get_dim()) : 0,
+                           wizard->get_nodes_visited(), wizard->get_solve_time(), wizard->get_peak_memory_usage());
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+
+    if (!parse_options(argc, argv, options)) {
+        fmt::println("Usage: {} [--target FILE] [--max N] [--output DIR] [--threads N] [--progress]\n"
+                     "       [--solve [--solve-threads N] [--time-limit MS] [--memory-limit MB]] <puzzle.txt>", argv[0]);
+        return 1;
+    }
+
+    PuzzleParser parser(256);
+
+    if (!parse_puzzle(options.input, parser))
+        return 1;
+
+    std::vector<utils::int3> target = Assembler::get_shape(parser.get_pieces(), parser.get_positions());
+
+    if (!options.target.empty()) {
+        PuzzleParser target_parser(256);
+
+        if (!parse_puzzle(options.target, target_parser))
+            return 1;
+
+        target = Assembler::get_shape(target_parser.get_pieces(), target_parser.get_positions());
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    Assembler assembler;
+
+    if (!assembler.load(parser.get_pieces(), target)) {
+        fmt::println("{}: {}", options.input.string(), assembler.get_error());
+        return 1;
+    }
+
+    assembler.set_threads(options.threads);
+
+    if (options.progress) {
+        assembler.set_progress_callback([](const AssemblyProgress& progress) {
+            fmt::println(stderr, "{}/{} tasks, {} assemblies, {} search nodes, ~{:.3g} remaining", progress.tasks_done, progress.tasks_total,
+                         progress.assemblies, progress.nodes_searched, progress.estimated_nodes_remaining);
+        });
+    }
+
+    if (!options.output.empty())
+        std::filesystem::create_directories(options.output);
+
+    const std::string stem = options.input.stem().string();
+    bool write_failed = false;
+    size_t found = 0;
+
+    BoundedQueue queue(options.solve_threads * 2);
+    std::mutex output_mutex;
+    std::vector<std::thread> solvers;
+
+    if (options.solve) {
+        for (size_t i = 0; i < options.solve_threads; i++) {
+            solvers.emplace_back([&]() {
+                while (auto job = queue.pop()) {
+                    std::string result = solve_assembly(*job, options.limits);
+
+                    std::lock_guard lock(output_mutex);
+                    fmt::println("{}", result);
+                    std::fflush(stdout);
+                }
+            });
+        }
+    }
+
+    const size_t count = assembler.assemble([&](const Assembly& assembly) {
+        found++;
+
+        if (options.solve)
+            queue.push({found, assembly});
+
+        if (!options.output.empty()) {
+            // Numbered by discovery order, which only depends on the input
+            const auto path = options.output / fmt::format("{}_assembly_{:06}.txt", stem, found);
+
+            if (!PuzzleParser::write(path, assembly.pieces, assembly.positions)) {
+                fmt::println("Failed to write {}", path.string());
+                write_failed = true;
+                return false;
+            }
+        }
+
+        return options.max_assemblies == 0 || found < options.max_assemblies;
+    });
+
+    queue.close();
+
+    for (auto& solver : solvers) {
+        solver.join();
+    }
+
+    auto end = std::chrono::steady_clock::now();
+
+    // Keeps stdout a clean stream of JSON lines when solving
+    fmt::println(options.solve ? stderr : stdout, "{}: {} assemblies, {} pieces in {} classes, {} placements, {} target symmetries, {} search nodes, {:.1f} ms",
+                 options.input.string(), count, parser.get_pieces().size(), assembler.get_num_classes(), assembler.get_num_placements(),
+                 assembler.get_num_symmetries(), assembler.get_num_search_nodes(), std::chrono::duration<double, std::milli>(end - start).count());
+
+    return write_failed ? 1 : 0;
+}
@@ -0,0 +1,192 @@
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <fmt/core.h>
+
+#include "json.h"
+#include "puzzle_solver.h"
+
+// Solves every puzzle of a directory or manifest on a thread pool and prints one JSON line per puzzle
+namespace
+{
+    struct Job
+    {
+        std::filesystem::path path;
+        uintmax_t cost;
+    };
+
+    struct Options
+    {
+        std::filesystem::path input;
+        size_t threads = std::max(1u, std::thread::hardware_concurrency());
+        SolverLimits limits;
+        SearchOptions search;
+        OccupancyBackend backend = OccupancyBackend::Auto;
+    };
+
+    bool is_puzzle_file(const std::filesystem::path& path)
+    {
+        return path.extension() == ".txt" || path.extension() == ".bpz";
+    }
+
+    bool collect_jobs(const std::filesystem::path& input, std::vector<Job>& jobs)
+    {
+        std::vector<std::filesystem::path> paths;
+
+        if (!std::filesystem::exists(input))
+            return false;
+
+        if (std::filesystem::is_directory(input)) {
+            for (const auto& entry : std::filesystem::directory_iterator(input)) {
+                if (entry.is_regular_file() && is_puzzle_file(entry.path()))
+                    paths.push_back(entry.path());
+            }
+        } else {
+            // Manifest: one puzzle per line, relative to the manifest, '#' starts a comment
+            std::ifstream stream(input);
+            std::string line;
+
+            if (!stream.is_open())
+                return false;
+
+            while (std::getline(stream, line)) {
+                line.erase(std::find(line.begin(), line.end(), '#'), line.end());
+                line.erase(line.find_last_not_of(" \t\r") + 1);
+                line.erase(0, line.find_first_not_of(" \t"));
+
+                if (!line.empty())
+                    paths.push_back(input.parent_path() / line);
+            }
+        }
+
+        std::ranges::sort(paths);
+
+        for (const auto& path : paths) {
+            std::error_code error;
+            uintmax_t size = std::filesystem::file_size(path, error);
+            jobs.push_back({path, error ? 0 : size});
+        }
+
+        // Shortest job first: the file size grows with the number of unit cubes, which is a cheap proxy for the
+        // solve cost. Small puzzles finish early instead of queueing behind large ones, limits bound the large ones.
+        std::ranges::stable_sort(jobs, {}, &Job::cost);
+
+        return true;
+    }
+
+    std::string solve_job(const Job& job, const Options& options)
+    {
+        std::vector<PuzzleParseError> errors;
+        std::unique_ptr<PuzzleSolver> wizard = open_puzzle(job.path, errors, options.backend);
+
+        if (!wizard) {
+            std::string message = errors.empty() ? "" : fmt::format("line {}: {}", errors[0].line, errors[0].message);
+
+            return fmt::format(R"({{"puzzle":"{}","status":"load_error","error":"{}"}})", escape_json(job.path.string()), escape_json(message));
+        }
+
+        wizard->init_field();
+        wizard->init_start_node();
+        wizard->set_limits(options.limits);
+        wizard->set_search_options(options.search);
+        wizard->solve();
+
+        return fmt::format(R"({{"puzzle":"{}","grid":{},"backend":"{}","mode":"{}","expansion":"{}","status":"{}","moves":{},"nodes":{},"ms":{:.3f},"peak_memory":{},"bytes_per_state":{:.1f}}})",
+                           escape_json(job.path.string()), wizard->get_dim(), to_string(wizard->get_backend()), to_string(options.search.mode), to_string(options.search.expansion), to_string(wizard->get_status()), wizard->get_solution().get_num_moves(),
+                           wizard->get_nodes_visited(), wizard->get_solve_time(), wizard->get_peak_memory_usage(), wizard->get_memory_usage().get_bytes_per_state());
+    }
+
+    template <typename T>
+    bool parse_number(std::string_view text, T& value)
+    {
+        auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+        return error == std::errc() && end == text.data() + text.size();
+    }
+
+    bool parse_options(int argc, char** argv, Options& options)
+    {
+        for (int i = 1; i < argc; i++) {
+            std::string_view argument = argv[i];
+
+            if (argument.starts_with("--") && i + 1 == argc)
+                return false;
+
+            if (argument == "--threads") {
+                if (!parse_number(argv[++i], options.threads) || options.threads == 0)
+                    return false;
+            } else if (argument == "--time-limit") {
+                if (!parse_number(argv[++i], options.limits.max_time_ms))
+                    return false;
+            } else if (argument == "--memory-limit") {
+                size_t megabytes;
+
+                if (!parse_number(argv[++i], megabytes))
+                    return false;
+
+                options.limits.max_memory_bytes = megabytes << 20;
+            } else if (argument == "--backend") {
+                if (!parse_occupancy_backend(argv[++i], options.backend))
+                    return false;
+            } else if (argument == "--mode") {
+                if (!parse_search_mode(argv[++i], options.search.mode))
+                    return false;
+            } else if (argument == "--expansion") {
+                if (!parse_expansion_mode(argv[++i], options.search.expansion))
+                    return false;
+            } else if (options.input.empty()) {
+                options.input = argument;
+            } else {
+                return false;
+            }
+        }
+
+        return !options.input.empty();
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+
+    if (!parse_options(argc, argv, options)) {
+        fmt::println("Usage: {} [--threads N] [--time-limit MS] [--memory-limit MB] [--backend auto|dense|sparse] [--mode greedy|astar|bfs] [--expansion full|partial] <directory|manifest>", argv[0]);
+        return 1;
+    }
+
+    std::vector<Job> jobs;
+
+    if (!collect_jobs(options.input, jobs)) {
+        fmt::println(stderr, "Could not read puzzles from {}", options.input.string());
+        return 1;
+    }
+
+    std::atomic<size_t> next_job = 0;
+    std::mutex output_mutex;
+    std::vector<std::thread> workers;
+
+    for (size_t i = 0; i < std::min(options.threads, jobs.size()); i++) {
+        workers.emplace_back([&]() {
+            for (size_t job = next_job++; job < jobs.size(); job = next_job++) {
+                std::string result = solve_job(jobs[job], options);
+
+                std::lock_guard lock(output_mutex);
+                fmt::println("{}", result);
+                std::fflush(stdout);
+            }
+        });
+    }
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    return 0;
+}
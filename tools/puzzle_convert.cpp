@@ -0,0 +1,43 @@
+#include <filesystem>
+#include <fmt/core.h>
+
+#include "binary_puzzle.h"
+#include "puzzle_parser.h"
+
+// Converts text puzzles from res/puzzles into the memory-mappable .bpz format
+int main(int argc, char** argv)
+{
+    std::vector<std::filesystem::path> paths;
+
+    for (int i = 1; i < argc; i++) {
+        paths.emplace_back(argv[i]);
+    }
+
+    if (paths.empty() || paths.size() > 2) {
+        fmt::println("Usage: {} <puzzle.txt> [puzzle.bpz]", argv[0]);
+        return 1;
+    }
+
+    const std::filesystem::path input = paths[0];
+    const std::filesystem::path output = paths.size() == 2 ? paths[1] : std::filesystem::path(input).replace_extension(".bpz");
+
+    // Local coordinates are stored as bytes, so 256 is the largest grid the format can describe
+    PuzzleParser parser(256);
+
+    if (!parser.parse_file(input)) {
+        for (const auto& error : parser.get_errors()) {
+            fmt::println("{}:{}: {}", input.string(), error.line, error.message);
+        }
+
+        return 1;
+    }
+
+    if (!BinaryPuzzle::write(output, parser.get_pieces(), parser.get_positions())) {
+        fmt::println("Failed to write {}", output.string());
+        return 1;
+    }
+
+    fmt::println("{} -> {} ({} pieces, {} bytes)", input.string(), output.string(), parser.get_pieces().size(), std::filesystem::file_size(output));
+
+    return 0;
+}